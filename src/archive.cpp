@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+#include <zlib.h>
+
+#include "archive.hpp"
+#include "macros/unwrap.hpp"
+
+namespace {
+auto read_u16(const std::byte* const ptr) -> uint16_t {
+    return uint16_t(ptr[0]) | uint16_t(ptr[1]) << 8;
+}
+
+auto read_u32(const std::byte* const ptr) -> uint32_t {
+    return uint32_t(read_u16(ptr)) | uint32_t(read_u16(ptr + 2)) << 16;
+}
+
+auto read_u64(const std::byte* const ptr) -> uint64_t {
+    return uint64_t(read_u32(ptr)) | uint64_t(read_u32(ptr + 4)) << 32;
+}
+
+auto has_extension(const std::string_view name, const std::string_view ext) -> bool {
+    return name.size() >= ext.size() &&
+           std::ranges::equal(name.substr(name.size() - ext.size()), ext, [](const char a, const char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+}
+
+auto is_zip(const std::string_view name) -> bool {
+    return has_extension(name, ".zip") || has_extension(name, ".cbz");
+}
+
+// tar header fields are nul or space terminated
+auto read_tar_string(const std::byte* const ptr, const size_t size) -> std::string_view {
+    const auto str = std::string_view(std::bit_cast<const char*>(ptr), size);
+    return str.substr(0, str.find('\0'));
+}
+
+auto read_tar_number(const std::byte* const ptr, const size_t size) -> std::optional<size_t> {
+    if(uint8_t(ptr[0]) & 0x80) {
+        // base-256, gnu extension for large files
+        auto value = size_t(uint8_t(ptr[0]) & 0x7f);
+        for(auto i = 1uz; i < size; i += 1) {
+            value = value << 8 | uint8_t(ptr[i]);
+        }
+        return value;
+    }
+    auto value = 0uz;
+    for(auto i = 0uz; i < size; i += 1) {
+        const auto c = char(ptr[i]);
+        if(c == ' ' && value == 0) {
+            continue;
+        }
+        if(c < '0' || c > '7') {
+            break;
+        }
+        value = value * 8 + (c - '0');
+    }
+    return value;
+}
+
+auto inflate_raw(const std::span<const std::byte> src, const size_t size) -> std::optional<std::vector<std::byte>> {
+    // the declared size is untrusted, deflate cannot expand more than 1032:1 and zlib counts in 32bit
+    constexpr auto max_ratio = 1032uz;
+    constexpr auto max_size  = size_t(std::numeric_limits<uInt>::max());
+    ensure(size <= max_size && src.size() <= max_size && size <= src.size() * max_ratio, "implausible inflated size {}", size);
+    auto dst    = std::vector<std::byte>(size);
+    auto stream = z_stream{};
+    ensure(inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+    stream.next_in   = std::bit_cast<Bytef*>(src.data());
+    stream.avail_in  = uInt(src.size());
+    stream.next_out  = std::bit_cast<Bytef*>(dst.data());
+    stream.avail_out = uInt(dst.size());
+    const auto ret   = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    ensure(ret == Z_STREAM_END && stream.total_out == size, "corrupted deflate stream");
+    return dst;
+}
+} // namespace
+
+auto Archive::add(std::string name, Member member) -> void {
+    if(name.empty() || name.back() == '/' || members.contains(name)) {
+        return;
+    }
+    names.push_back(name);
+    members.emplace(std::move(name), member);
+}
+
+auto Archive::index_zip() -> bool {
+    const auto data = file.get();
+    const auto end  = data.data() + data.size();
+
+    // end of central directory record, followed by a comment of up to 64KiB
+    constexpr auto eocd_size = 22uz;
+    ensure(data.size() >= eocd_size, "too small for a zip");
+    auto eocd = (const std::byte*)(nullptr);
+    for(auto back = eocd_size; back <= data.size() && back <= eocd_size + 0xffff; back += 1) {
+        if(read_u32(end - back) == 0x06054b50) {
+            eocd = end - back;
+            break;
+        }
+    }
+    ensure(eocd != nullptr, "no end of central directory");
+    auto count     = size_t(read_u16(eocd + 10));
+    auto cd_size   = size_t(read_u32(eocd + 12));
+    auto cd_offset = size_t(read_u32(eocd + 16));
+    if(count == 0xffff || cd_size == 0xffffffff || cd_offset == 0xffffffff) {
+        // zip64
+        ensure(eocd - data.data() >= 20 && read_u32(eocd - 20) == 0x07064b50, "no zip64 locator");
+        const auto offset = size_t(read_u64(eocd - 20 + 8));
+        ensure(offset <= data.size() && data.size() - offset >= 56 && read_u32(data.data() + offset) == 0x06064b50, "no zip64 end of central directory");
+        const auto eocd64 = data.data() + offset;
+        count             = read_u64(eocd64 + 32);
+        cd_size           = read_u64(eocd64 + 40);
+        cd_offset         = read_u64(eocd64 + 48);
+    }
+    // the fields are untrusted, compare without sums which could wrap around
+    ensure(cd_size <= data.size() && cd_offset <= data.size() - cd_size, "central directory out of range");
+
+    auto ptr = data.data() + cd_offset;
+    for(auto i = 0uz; i < count; i += 1) {
+        ensure(end - ptr >= 46 && read_u32(ptr) == 0x02014b50, "broken central directory");
+        const auto flags       = read_u16(ptr + 8);
+        const auto method      = read_u16(ptr + 10);
+        auto       compressed  = size_t(read_u32(ptr + 20));
+        auto       size        = size_t(read_u32(ptr + 24));
+        const auto name_len    = read_u16(ptr + 28);
+        const auto extra_len   = read_u16(ptr + 30);
+        const auto comment_len = read_u16(ptr + 32);
+        auto       offset      = size_t(read_u32(ptr + 42));
+        ensure(end - ptr >= 46 + name_len + extra_len + comment_len, "broken central directory");
+        auto name = std::string(std::bit_cast<const char*>(ptr + 46), name_len);
+
+        // zip64 extended information, only the fields saturated in the record are present
+        const auto extra_e = ptr + 46 + name_len + extra_len;
+        for(auto extra = ptr + 46 + name_len; extra_e - extra >= 4;) {
+            const auto id  = read_u16(extra);
+            const auto len = read_u16(extra + 2);
+            ensure(extra_e - extra - 4 >= len, "extra field out of range");
+            auto       field    = extra + 4;
+            const auto fields_e = field + len;
+            if(id == 0x0001) {
+                for(auto value : {&size, &compressed, &offset}) {
+                    if(*value == 0xffffffff && field + 8 <= fields_e) {
+                        *value  = read_u64(field);
+                        field  += 8;
+                    }
+                }
+            }
+            extra = fields_e;
+        }
+
+        // skip encrypted and unsupported members
+        if(!(flags & 1) && (method == 0 || method == 8)) {
+            add(std::move(name), Member{offset, compressed, size, method});
+        }
+        ptr += 46 + name_len + extra_len + comment_len;
+    }
+    return true;
+}
+
+auto Archive::index_tar() -> bool {
+    const auto data = file.get();
+
+    auto long_name = std::optional<std::string>();
+    for(auto offset = 0uz; offset + 512 <= data.size();) {
+        const auto header = data.data() + offset;
+        if(std::all_of(header, header + 512, [](const std::byte b) { return b == std::byte(0); })) {
+            break;
+        }
+        unwrap(size, read_tar_number(header + 124, 12));
+        const auto type  = char(header[156]);
+        const auto body  = offset + 512;
+        const auto next  = body + (size + 511) / 512 * 512;
+        ensure(size <= data.size() - body, "tar member out of range");
+
+        switch(type) {
+        case 'L': // gnu long name
+            long_name = std::string(read_tar_string(data.data() + body, size));
+            break;
+        case 'x': { // pax extended header, "<len> <key>=<value>\n" records
+            auto records = std::string_view(std::bit_cast<const char*>(data.data() + body), size);
+            while(!records.empty()) {
+                const auto space = records.find(' ');
+                auto       len   = 0uz;
+                for(const auto c : records.substr(0, space)) {
+                    len = len * 10 + (c - '0');
+                }
+                if(space == records.npos || len == 0 || len > records.size()) {
+                    break;
+                }
+                const auto record = records.substr(space + 1, len - space - 2);
+                if(record.starts_with("path=")) {
+                    long_name = std::string(record.substr(5));
+                }
+                records = records.substr(len);
+            }
+        } break;
+        case '0':
+        case '\0': {
+            auto name = std::string();
+            if(long_name) {
+                name = std::move(*long_name);
+                long_name.reset();
+            } else {
+                const auto prefix = std::string(read_tar_string(header + 345, 155));
+                name              = prefix.empty() ? std::string(read_tar_string(header, 100)) : prefix + "/" + std::string(read_tar_string(header, 100));
+            }
+            add(std::move(name), Member{body, size, size, 0});
+        } break;
+        default:
+            long_name.reset();
+            break;
+        }
+        offset = next;
+    }
+    return true;
+}
+
+auto Archive::is_archive(const std::string_view name) -> bool {
+    return is_zip(name) || has_extension(name, ".tar") || has_extension(name, ".cbt");
+}
+
+auto Archive::open(const std::filesystem::path& path) -> std::shared_ptr<Archive> {
+    unwrap_mut(file, MappedFile::open(path.c_str()));
+    auto archive  = std::shared_ptr<Archive>(new Archive());
+    archive->file = std::move(file);
+    archive->zip  = is_zip(path.filename().string());
+    if(archive->zip) {
+        ensure(archive->index_zip(), "failed to read zip {}", path.string());
+    } else {
+        ensure(archive->index_tar(), "failed to read tar {}", path.string());
+    }
+    return archive;
+}
+
+auto Archive::get_names() const -> const std::vector<std::string>& {
+    return names;
+}
+
+auto Archive::read(const std::string& name) const -> std::optional<FileData> {
+    const auto it = members.find(name);
+    ensure(it != members.end(), "no such member {}", name);
+    const auto& member = it->second;
+    const auto  data   = file.get();
+
+    auto offset = member.offset;
+    if(zip) {
+        // the local header may have a different extra field than the central directory
+        ensure(offset <= data.size() && data.size() - offset >= 30 && read_u32(data.data() + offset) == 0x04034b50, "broken local header for {}", name);
+        offset += 30 + read_u16(data.data() + offset + 26) + read_u16(data.data() + offset + 28);
+    }
+    ensure(offset <= data.size() && member.compressed_size <= data.size() - offset, "member {} out of range", name);
+    const auto bytes = data.subspan(offset, member.compressed_size);
+    if(member.method == 0) {
+        ensure(bytes.size() == member.size);
+        return FileData{shared_from_this(), bytes};
+    }
+    unwrap_mut(inflated, inflate_raw(bytes, member.size), "failed to inflate {}", name);
+    auto owner = std::make_shared<std::vector<std::byte>>(std::move(inflated));
+    return FileData{owner, *owner};
+}
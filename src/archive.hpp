@@ -0,0 +1,40 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "file-data.hpp"
+#include "mapped-file.hpp"
+
+// read-only zip or tar archive
+// the member index is built once on open, members are read straight from the mapping
+class Archive : public std::enable_shared_from_this<Archive> {
+  private:
+    struct Member {
+        size_t   offset; // zip: local header, tar: data
+        size_t   compressed_size;
+        size_t   size;
+        uint16_t method; // zip compression method, 0 for tar
+    };
+
+    MappedFile                              file;
+    bool                                    zip;
+    std::vector<std::string>                names;
+    std::unordered_map<std::string, Member> members;
+
+    auto add(std::string name, Member member) -> void;
+    auto index_zip() -> bool;
+    auto index_tar() -> bool;
+
+  public:
+    // by extension
+    static auto is_archive(std::string_view name) -> bool;
+    static auto open(const std::filesystem::path& path) -> std::shared_ptr<Archive>;
+
+    // regular files, in archive order
+    auto get_names() const -> const std::vector<std::string>&;
+    auto read(const std::string& name) const -> std::optional<FileData>;
+};
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <unordered_map>
+
+#include <coop/generator.hpp>
+#include <coop/multi-event.hpp>
+#include <coop/timer.hpp>
+#include <sys/resource.h>
+
+#include "../config.hpp"
+#include "../displayable/image.hpp"
+#include "../file-list.hpp"
+#include "../macros/unwrap.hpp"
+#include "../page-cache.hpp"
+#include "../pipeline.hpp"
+#include "../readahead.hpp"
+#include "../util/charconv.hpp"
+
+// drives the pipeline like the viewer does, without a window
+// pages are decoded but never uploaded, so no gpu is needed
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto keep_range    = 1uz;
+constexpr auto screen_size   = std::array{1920uz, 1080uz}; // for --decode-to-screen
+constexpr auto default_flips = 100uz;
+
+auto to_ms(const Clock::duration duration) -> double {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+auto percentile(std::vector<double> values, const double p) -> double {
+    if(values.empty()) {
+        return 0;
+    }
+    const auto i = std::min(values.size() - 1, size_t(p * values.size()));
+    std::ranges::nth_element(values, values.begin() + i);
+    return values[i];
+}
+
+class Bench {
+  private:
+    Config                                                    config;
+    FileList                                                  list;
+    PageCache                                                 cache;
+    Pipeline                                                  pipeline;
+    std::unordered_map<const Displayable*, Clock::time_point> started; // claimed pages
+    coop::MultiEvent                                          loaded_event;
+    std::optional<DiskCache>                                  disk_cache;
+    std::optional<Readahead>                                  readahead;
+
+    // results
+    std::vector<double> latencies; // claim to decoded, ms
+    std::vector<double> stalls;    // flip to displayable, ms
+    Clock::duration     first_page;
+    size_t              hits     = 0;
+    size_t              misses   = 0;
+    size_t              failures = 0;
+
+    auto schedule() -> std::shared_ptr<Job> {
+        const auto i = cache.next_claim(list.index, 1, list.files.size(), keep_range, config.cache_budget);
+        if(!i) {
+            return nullptr;
+        }
+        const auto fit_box     = config.decode_to_screen ? screen_size : std::array{0uz, 0uz};
+        const auto displayable = std::shared_ptr<Displayable>(new DisplayableImage(fit_box));
+        cache.set(*i, displayable);
+        started[displayable.get()] = Clock::now();
+        return std::shared_ptr<Job>(new Job{.work = list.prefix, .index = *i, .file = std::string(list.files[*i]), .archive = list.archive, .displayable = displayable});
+    }
+
+    auto prioritize(const Job& job) const -> std::optional<size_t> {
+        if(cache.peek(job.index) != job.displayable.get()) {
+            return std::nullopt;
+        }
+        return cache.priority(job.index, list.index, 1, list.files.size(), keep_range, config.cache_budget);
+    }
+
+    auto finish(const std::shared_ptr<Job> job) -> void {
+        if(cache.peek(job->index) != job->displayable.get()) {
+            return;
+        }
+        if(job->cancelled) {
+            started.erase(job->displayable.get());
+            cache.erase(job->index);
+            return;
+        }
+        if(job->preview) {
+            // the viewer would draw this, count it as displayable
+            job->displayable->state = Displayable::State::Preview;
+            loaded_event.notify();
+            return;
+        }
+        if(const auto it = started.find(job->displayable.get()); it != started.end()) {
+            latencies.push_back(to_ms(Clock::now() - it->second));
+            started.erase(it);
+        }
+        failures += job->ok ? 0 : 1;
+        job->displayable->state = Displayable::State::Loaded;
+        cache.set(job->index, std::move(job->displayable));
+        cache.evict(list.index, keep_range, config.cache_budget);
+        loaded_event.notify();
+    }
+
+    // paging forward
+    auto request_readahead() -> void {
+        if(!readahead || list.archive) {
+            return;
+        }
+        auto paths = std::vector<std::string>();
+        for(const auto i : cache.beyond_budget(list.index, false, config.readahead, list.files.size(), keep_range, config.cache_budget)) {
+            paths.push_back((list.prefix / list.files[i]).string());
+        }
+        readahead->request(std::move(paths));
+    }
+
+    auto is_displayable() const -> bool {
+        const auto current = cache.peek(list.index);
+        return current != nullptr && current->state != Displayable::State::Loading;
+    }
+
+  public:
+    auto run(const size_t flips, const std::chrono::milliseconds interval) -> coop::Async<void> {
+        auto&      runner = *(co_await coop::reveal_runner());
+        const auto begin  = Clock::now();
+        pipeline.start(runner);
+        while(!is_displayable()) {
+            co_await loaded_event;
+        }
+        first_page = Clock::now() - begin;
+
+        for(auto flip = 0uz; flip < flips && list.index + 1 < list.files.size(); flip += 1) {
+            co_await coop::sleep(interval);
+            list.index += 1;
+            pipeline.notify();
+            request_readahead();
+            if(is_displayable()) {
+                hits += 1;
+                stalls.push_back(0);
+                continue;
+            }
+            misses += 1;
+            const auto flipped = Clock::now();
+            while(!is_displayable()) {
+                co_await loaded_event;
+            }
+            stalls.push_back(to_ms(Clock::now() - flipped));
+        }
+        pipeline.stop();
+    }
+
+    auto report() const -> void {
+        auto usage = rusage();
+        getrusage(RUSAGE_SELF, &usage);
+        const auto flips = hits + misses;
+
+        std::println("pages:          {} ({} failed to decode)", list.files.size(), failures);
+        std::println("first page:     {:.2f}ms", to_ms(first_page));
+        std::println("decode latency: p50 {:.2f}ms p90 {:.2f}ms p99 {:.2f}ms max {:.2f}ms ({} pages)",
+                     percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99), percentile(latencies, 1.0), latencies.size());
+        std::println("flip stall:     p50 {:.2f}ms p99 {:.2f}ms max {:.2f}ms",
+                     percentile(stalls, 0.5), percentile(stalls, 0.99), percentile(stalls, 1.0));
+        std::println("cache hits:     {}/{} ({:.1f}%)", hits, flips, flips == 0 ? 0.0 : 100.0 * hits / flips);
+        std::println("peak rss:       {:.1f}MiB", usage.ru_maxrss / 1024.0);
+    }
+
+    Bench(Config config, FileList list)
+        : config(std::move(config)),
+          list(std::move(list)),
+          pipeline(
+              [this]() { return schedule(); },
+              [this](const Job& job) { return prioritize(job); },
+              [](const std::function<bool()>& /*upload*/) { return true; },
+              [this](std::shared_ptr<Job> job) { finish(std::move(job)); }) {
+        if(this->config.disk_cache != 0) {
+            if(const auto root = DiskCache::default_root()) {
+                std::filesystem::create_directories(*root);
+                disk_cache.emplace(*root, this->config.disk_cache);
+                pipeline.set_disk_cache(&*disk_cache);
+            }
+        }
+        if(this->config.readahead != 0) {
+            readahead.emplace(this->config.readahead_depth);
+        }
+    }
+};
+
+// usage: pipeline-bench [--cache-budget=MiB] [--decode-to-screen] [--disk-cache=MiB] [--readahead=FILES] DIR [FLIPS] [INTERVAL_MS]
+auto run(const int argc, const char* const argv[]) -> bool {
+    auto config = Config();
+    unwrap(args, parse_args(argc, argv, config));
+    ensure(!args.empty(), "usage: {} [options] DIR [FLIPS] [INTERVAL_MS]", argv[0]);
+    auto flips    = default_flips;
+    auto interval = std::chrono::milliseconds(0);
+    if(args.size() >= 2) {
+        unwrap(value, from_chars<size_t>(args[1]), "invalid flip count {}", args[1]);
+        flips = value;
+    }
+    if(args.size() >= 3) {
+        unwrap(value, from_chars<size_t>(args[2]), "invalid interval {}", args[2]);
+        interval = std::chrono::milliseconds(value);
+    }
+
+    unwrap_mut(list, list_files(std::filesystem::absolute(args[0]).string(), FileFilter::Images));
+    // text pages need a font
+    list.files.erase_if([](const std::string_view file) { return file.ends_with(".txt"); });
+    ensure(!list.files.empty(), "no images in {}", args[0]);
+
+    auto bench  = Bench(std::move(config), std::move(list));
+    auto runner = coop::Runner();
+    runner.push_task(bench.run(flips, interval));
+    runner.run();
+    bench.report();
+    return true;
+}
+} // namespace
+
+auto main(const int argc, const char* const argv[]) -> int {
+    return run(argc, argv) ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#include <array>
+#include <chrono>
+#include <print>
+#include <random>
+
+#include "../sort.hpp"
+
+namespace {
+auto generate_names(const size_t count, std::mt19937_64& rng) -> NameList {
+    constexpr auto chars      = std::string_view("0123456789abcdefABCDEF");
+    constexpr auto extensions = std::array{".jpg", ".png", ".webp", ".JPG"};
+
+    auto ret = NameList();
+    for(auto i = 0uz; i < count; i += 1) {
+        auto name = std::format("{}_{:06}_", i % 3 == 0 ? "IMG" : "scan", rng() % 1000000);
+        for(auto c = 0; c < 24; c += 1) {
+            name += chars[rng() % chars.size()];
+        }
+        name += extensions[rng() % extensions.size()];
+        ret.push_back(name);
+    }
+    return ret;
+}
+} // namespace
+
+auto main() -> int {
+    constexpr auto counts = std::array{1'000uz, 10'000uz, 100'000uz, 1'000'000uz};
+    constexpr auto runs   = 5;
+
+    auto rng = std::mt19937_64(0);
+    for(const auto count : counts) {
+        const auto names = generate_names(count, rng);
+
+        auto best  = std::chrono::nanoseconds::max();
+        auto total = std::chrono::nanoseconds(0);
+        for(auto run = 0; run < runs; run += 1) {
+            auto       copy  = names;
+            const auto begin = std::chrono::steady_clock::now();
+            sort_strings(copy);
+            const auto elapsed = std::chrono::steady_clock::now() - begin;
+            best               = std::min(best, elapsed);
+            total             += elapsed;
+        }
+        std::println("{:>8} names: best {:.3f}ms avg {:.3f}ms",
+                     count,
+                     std::chrono::duration<double, std::milli>(best).count(),
+                     std::chrono::duration<double, std::milli>(total).count() / runs);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <cstring>
+
+#include "animation.hpp"
+
+namespace {
+auto starts_with(const std::span<const std::byte> data, const size_t offset, const std::string_view magic) -> bool {
+    return data.size() >= offset + magic.size() && std::memcmp(data.data() + offset, magic.data(), magic.size()) == 0;
+}
+} // namespace
+
+auto frame_duration(const int64_t ms) -> std::chrono::milliseconds {
+    return std::chrono::milliseconds(ms <= 10 ? 100 : ms);
+}
+
+auto open_animation(FileData data) -> std::unique_ptr<AnimationDecoder> {
+    const auto bytes = data.bytes;
+    if(starts_with(bytes, 0, "GIF87a") || starts_with(bytes, 0, "GIF89a")) {
+        return open_gif(std::move(data));
+    }
+#if defined(IMGVIEW_WEBP)
+    if(starts_with(bytes, 0, "RIFF") && starts_with(bytes, 8, "WEBP")) {
+        return open_webp(std::move(data));
+    }
+#endif
+#if defined(IMGVIEW_AVIF)
+    // image sequences use the avis brand
+    if(starts_with(bytes, 4, "ftypavis")) {
+        return open_avif(std::move(data));
+    }
+#endif
+    return nullptr;
+}
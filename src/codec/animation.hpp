@@ -0,0 +1,41 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../file-data.hpp"
+
+// larger canvases are refused instead of allocated, a frame of this size is 64MiB of rgba
+constexpr auto max_animation_pixels = 4096uz * 4096;
+
+struct Frame {
+    std::vector<std::byte>    pixels; // rgba, canvas size
+    std::chrono::milliseconds duration;
+};
+
+// decodes frames one at a time, keeping only the state needed for the next one
+class AnimationDecoder {
+  public:
+    virtual auto get_width() const -> size_t  = 0;
+    virtual auto get_height() const -> size_t = 0;
+    // wraps around to the first frame after the last one
+    virtual auto next() -> std::optional<Frame> = 0;
+
+    virtual ~AnimationDecoder() {}
+};
+
+// like browsers, durations of 10ms or less play as 100ms
+auto frame_duration(int64_t ms) -> std::chrono::milliseconds;
+
+// returns null if data is not an animation, a still image or a format without a decoder built in
+// the decoder keeps data alive and reads frames from it as they are needed
+auto open_animation(FileData data) -> std::unique_ptr<AnimationDecoder>;
+
+auto open_gif(FileData data) -> std::unique_ptr<AnimationDecoder>;
+#if defined(IMGVIEW_WEBP)
+auto open_webp(FileData data) -> std::unique_ptr<AnimationDecoder>;
+#endif
+#if defined(IMGVIEW_AVIF)
+auto open_avif(FileData data) -> std::unique_ptr<AnimationDecoder>;
+#endif
@@ -0,0 +1,63 @@
+#include <bit>
+
+#include <avif/avif.h>
+
+#include "../macros/assert.hpp"
+#include "animation.hpp"
+
+namespace {
+class AVIFDecoder : public AnimationDecoder {
+  private:
+    FileData     data;
+    avifDecoder* decoder;
+
+  public:
+    auto get_width() const -> size_t override {
+        return decoder->image->width;
+    }
+
+    auto get_height() const -> size_t override {
+        return decoder->image->height;
+    }
+
+    auto next() -> std::optional<Frame> override {
+        auto result = avifDecoderNextImage(decoder);
+        if(result == AVIF_RESULT_NO_IMAGES_REMAINING) {
+            ensure(avifDecoderReset(decoder) == AVIF_RESULT_OK);
+            result = avifDecoderNextImage(decoder);
+        }
+        ensure(result == AVIF_RESULT_OK, "failed to decode avif frame: {}", avifResultToString(result));
+
+        const auto image = decoder->image;
+        auto       frame = Frame{std::vector<std::byte>(size_t(image->width) * image->height * 4), frame_duration(int64_t(decoder->imageTiming.duration * 1000))};
+        auto       rgb   = avifRGBImage();
+        avifRGBImageSetDefaults(&rgb, image);
+        rgb.format   = AVIF_RGB_FORMAT_RGBA;
+        rgb.depth    = 8;
+        rgb.pixels   = std::bit_cast<uint8_t*>(frame.pixels.data());
+        rgb.rowBytes = image->width * 4;
+        ensure(avifImageYUVToRGB(image, &rgb) == AVIF_RESULT_OK);
+        return frame;
+    }
+
+    AVIFDecoder(FileData data, avifDecoder* const decoder)
+        : data(std::move(data)),
+          decoder(decoder) {}
+
+    ~AVIFDecoder() {
+        avifDecoderDestroy(decoder);
+    }
+};
+} // namespace
+
+auto open_avif(FileData data) -> std::unique_ptr<AnimationDecoder> {
+    const auto decoder = avifDecoderCreate();
+    ensure(decoder != nullptr);
+    // the decoder references the bytes, which stay alive in data
+    if(avifDecoderSetIOMemory(decoder, std::bit_cast<const uint8_t*>(data.bytes.data()), data.bytes.size()) != AVIF_RESULT_OK ||
+       avifDecoderParse(decoder) != AVIF_RESULT_OK || decoder->imageCount <= 1) {
+        avifDecoderDestroy(decoder);
+        return nullptr;
+    }
+    return std::unique_ptr<AnimationDecoder>(new AVIFDecoder(std::move(data), decoder));
+}
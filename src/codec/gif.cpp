@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <array>
+
+#include "../macros/assert.hpp"
+#include "animation.hpp"
+
+namespace {
+auto read_u16(const std::byte* const ptr) -> uint16_t {
+    return uint16_t(ptr[0]) | uint16_t(ptr[1]) << 8;
+}
+
+// concatenated data sub-blocks starting at a cursor
+class SubBlockReader {
+  private:
+    std::span<const std::byte> data;
+    size_t                     pos;
+    size_t                     remain = 0; // bytes left in the current sub-block
+    bool                       done   = false;
+
+  public:
+    auto next_byte() -> std::optional<uint8_t> {
+        while(remain == 0) {
+            if(done || pos >= data.size()) {
+                return std::nullopt;
+            }
+            remain = size_t(data[pos]);
+            pos   += 1;
+            if(remain == 0) {
+                done = true;
+                return std::nullopt;
+            }
+        }
+        if(pos >= data.size()) {
+            return std::nullopt;
+        }
+        remain -= 1;
+        return uint8_t(data[pos++]);
+    }
+
+    // position after the block terminator
+    auto skip() -> size_t {
+        while(next_byte()) {
+        }
+        return pos;
+    }
+
+    SubBlockReader(const std::span<const std::byte> data, const size_t pos)
+        : data(data),
+          pos(pos) {}
+};
+
+// decodes lzw compressed color indices into out, returns the number of pixels decoded
+auto decode_lzw(SubBlockReader& reader, const int min_code_size, std::span<uint8_t> out) -> size_t {
+    if(min_code_size < 2 || min_code_size > 11) {
+        return 0;
+    }
+    const auto clear = 1 << min_code_size;
+    const auto eoi   = clear + 1;
+
+    auto prefix = std::array<uint16_t, 4096>();
+    auto suffix = std::array<uint8_t, 4096>();
+    auto stack  = std::array<uint8_t, 4097>();
+    for(auto i = 0; i < clear; i += 1) {
+        suffix[i] = uint8_t(i);
+    }
+
+    auto code_size = min_code_size + 1;
+    auto next      = clear + 2;
+    auto prev      = -1;
+    auto first     = 0;
+    auto bits      = 0u;
+    auto bit_count = 0;
+    auto written   = 0uz;
+    while(written < out.size()) {
+        while(bit_count < code_size) {
+            const auto byte = reader.next_byte();
+            if(!byte) {
+                return written;
+            }
+            bits      |= *byte << bit_count;
+            bit_count += 8;
+        }
+        auto code  = int(bits & ((1u << code_size) - 1));
+        bits     >>= code_size;
+        bit_count -= code_size;
+
+        if(code == clear) {
+            code_size = min_code_size + 1;
+            next      = clear + 2;
+            prev      = -1;
+            continue;
+        }
+        if(code == eoi) {
+            break;
+        }
+        if(prev == -1) {
+            if(code >= clear) {
+                break;
+            }
+            out[written++] = uint8_t(code);
+            first          = code;
+            prev           = code;
+            continue;
+        }
+
+        const auto in = code;
+        auto       sp = 0uz;
+        if(code >= next) {
+            if(code > next) {
+                break;
+            }
+            // the code being defined right now, kwkwk case
+            stack[sp++] = uint8_t(first);
+            code        = prev;
+        }
+        while(code >= clear) {
+            stack[sp++] = suffix[code];
+            code        = prefix[code];
+        }
+        first       = code;
+        stack[sp++] = uint8_t(first);
+        while(sp > 0 && written < out.size()) {
+            out[written++] = stack[--sp];
+        }
+
+        if(next < 4096) {
+            prefix[next] = uint16_t(prev);
+            suffix[next] = uint8_t(first);
+            next        += 1;
+            if(next == (1 << code_size) && code_size < 12) {
+                code_size += 1;
+            }
+        }
+        prev = in;
+    }
+    return written;
+}
+
+class GIFDecoder : public AnimationDecoder {
+  private:
+    enum Disposal : uint8_t {
+        None       = 0,
+        Keep       = 1,
+        Background = 2,
+        Previous   = 3,
+    };
+
+    struct Rect {
+        size_t x;
+        size_t y;
+        size_t width;
+        size_t height;
+    };
+
+    FileData               data;
+    size_t                 width;
+    size_t                 height;
+    std::span<const std::byte> global_palette;
+    size_t                 first_block;
+
+    // composition state
+    size_t                 pos;
+    std::vector<std::byte> canvas;
+    std::vector<std::byte> saved; // canvas before the previous frame, for Disposal::Previous
+    Disposal               last_disposal = Disposal::None;
+    Rect                   last_rect     = {};
+    std::vector<uint8_t>   indices;
+
+    auto rewind() -> void {
+        pos           = first_block;
+        last_disposal = Disposal::None;
+        std::ranges::fill(canvas, std::byte(0));
+    }
+
+    auto dispose() -> void {
+        switch(last_disposal) {
+        case Disposal::Background:
+            // browsers clear to transparent rather than the background color
+            for(auto y = last_rect.y; y < last_rect.y + last_rect.height; y += 1) {
+                const auto row = canvas.data() + (y * width + last_rect.x) * 4;
+                std::fill(row, row + last_rect.width * 4, std::byte(0));
+            }
+            break;
+        case Disposal::Previous:
+            canvas = saved;
+            break;
+        default:
+            break;
+        }
+    }
+
+  public:
+    auto get_width() const -> size_t override {
+        return width;
+    }
+
+    auto get_height() const -> size_t override {
+        return height;
+    }
+
+    auto next() -> std::optional<Frame> override {
+        const auto bytes = data.bytes;
+
+        auto disposal     = Disposal::None;
+        auto delay        = 0;
+        auto transparent  = -1;
+        auto wrapped      = false;
+    loop:
+        if(pos >= bytes.size() || bytes[pos] == std::byte(0x3b)) {
+            // trailer
+            ensure(!wrapped, "no frames in gif");
+            wrapped = true;
+            rewind();
+            goto loop;
+        }
+        switch(uint8_t(bytes[pos])) {
+        case 0x21: { // extension
+            ensure(pos + 2 <= bytes.size());
+            const auto label = uint8_t(bytes[pos + 1]);
+            if(label == 0xf9 && pos + 8 <= bytes.size() && uint8_t(bytes[pos + 2]) == 4) {
+                // graphic control
+                const auto packed = uint8_t(bytes[pos + 3]);
+                disposal          = Disposal((packed >> 2) & 0x07);
+                delay             = read_u16(bytes.data() + pos + 4);
+                transparent       = (packed & 0x01) ? int(bytes[pos + 6]) : -1;
+            }
+            pos = SubBlockReader(bytes, pos + 2).skip();
+            goto loop;
+        }
+        case 0x2c: { // image descriptor
+            ensure(pos + 10 <= bytes.size(), "truncated gif");
+            const auto left      = size_t(read_u16(bytes.data() + pos + 1));
+            const auto top       = size_t(read_u16(bytes.data() + pos + 3));
+            const auto w         = size_t(read_u16(bytes.data() + pos + 5));
+            const auto h         = size_t(read_u16(bytes.data() + pos + 7));
+            const auto packed    = uint8_t(bytes[pos + 9]);
+            const auto interlace = (packed & 0x40) != 0;
+            ensure(w * h <= max_animation_pixels, "gif frame too large {}x{}", w, h);
+            pos += 10;
+
+            auto palette = global_palette;
+            if(packed & 0x80) {
+                const auto size = 3uz << ((packed & 0x07) + 1);
+                ensure(pos + size <= bytes.size(), "truncated gif");
+                palette  = bytes.subspan(pos, size);
+                pos     += size;
+            }
+            ensure(pos < bytes.size(), "truncated gif");
+            const auto min_code_size = int(bytes[pos]);
+            auto       reader        = SubBlockReader(bytes, pos + 1);
+
+            indices.assign(w * h, transparent >= 0 ? uint8_t(transparent) : 0);
+            decode_lzw(reader, min_code_size, indices);
+            pos = reader.skip();
+
+            dispose();
+            if(disposal == Disposal::Previous) {
+                saved = canvas;
+            }
+
+            // frame rect clipped to the canvas
+            const auto rect = Rect{std::min(left, width), std::min(top, height), std::min(w, width - std::min(left, width)), std::min(h, height - std::min(top, height))};
+            for(auto row = 0uz; row < h; row += 1) {
+                // interlaced rows are stored in passes of every 8th, 8th from 4, 4th from 2, 2nd from 1
+                auto y = row;
+                if(interlace) {
+                    const auto p1 = (h + 7) / 8, p2 = (h + 3) / 8, p3 = (h + 1) / 4;
+                    y             = row < p1             ? row * 8
+                                    : row < p1 + p2      ? (row - p1) * 8 + 4
+                                    : row < p1 + p2 + p3 ? (row - p1 - p2) * 4 + 2
+                                                         : (row - p1 - p2 - p3) * 2 + 1;
+                }
+                if(y >= rect.height) {
+                    continue;
+                }
+                for(auto x = 0uz; x < rect.width; x += 1) {
+                    const auto index = indices[row * w + x];
+                    if(int(index) == transparent || index * 3uz + 2 >= palette.size()) {
+                        continue;
+                    }
+                    const auto dst = canvas.data() + ((rect.y + y) * width + rect.x + x) * 4;
+                    dst[0]         = palette[index * 3 + 0];
+                    dst[1]         = palette[index * 3 + 1];
+                    dst[2]         = palette[index * 3 + 2];
+                    dst[3]         = std::byte(0xff);
+                }
+            }
+            last_disposal = disposal;
+            last_rect     = rect;
+
+            // delays are in 10ms units
+            return Frame{canvas, frame_duration(delay * 10)};
+        }
+        default:
+            bail("unknown gif block {}", int(bytes[pos]));
+        }
+    }
+
+    GIFDecoder(FileData data_, const size_t width, const size_t height, const std::span<const std::byte> global_palette, const size_t first_block)
+        : data(std::move(data_)),
+          width(width),
+          height(height),
+          global_palette(global_palette),
+          first_block(first_block),
+          pos(first_block),
+          canvas(width * height * 4) {}
+};
+
+// counts image descriptors, stopping at 2
+auto is_animated(const std::span<const std::byte> bytes, size_t pos) -> bool {
+    auto frames = 0;
+    while(pos < bytes.size() && frames < 2) {
+        switch(uint8_t(bytes[pos])) {
+        case 0x21:
+            pos = SubBlockReader(bytes, pos + 2).skip();
+            break;
+        case 0x2c: {
+            if(pos + 10 > bytes.size()) {
+                return false;
+            }
+            const auto packed  = uint8_t(bytes[pos + 9]);
+            pos               += 10 + ((packed & 0x80) ? 3uz << ((packed & 0x07) + 1) : 0);
+            pos                = SubBlockReader(bytes, pos + 1).skip();
+            frames            += 1;
+        } break;
+        default:
+            return false;
+        }
+    }
+    return frames >= 2;
+}
+} // namespace
+
+auto open_gif(FileData data) -> std::unique_ptr<AnimationDecoder> {
+    const auto bytes = data.bytes;
+    ensure(bytes.size() >= 13);
+    const auto width  = size_t(read_u16(bytes.data() + 6));
+    const auto height = size_t(read_u16(bytes.data() + 8));
+    const auto packed = uint8_t(bytes[10]);
+    ensure(width != 0 && height != 0);
+    ensure(width * height <= max_animation_pixels, "gif too large {}x{}", width, height);
+
+    auto pos     = 13uz;
+    auto palette = std::span<const std::byte>();
+    if(packed & 0x80) {
+        const auto size = 3uz << ((packed & 0x07) + 1);
+        ensure(pos + size <= bytes.size());
+        palette  = bytes.subspan(pos, size);
+        pos     += size;
+    }
+    if(!is_animated(bytes, pos)) {
+        return nullptr;
+    }
+    return std::unique_ptr<AnimationDecoder>(new GIFDecoder(std::move(data), width, height, palette, pos));
+}
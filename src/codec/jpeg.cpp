@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <bit>
+#include <csetjmp>
+#include <cstdio>
+
+#include <jpeglib.h>
+
+#include "../resample.hpp"
+#include "jpeg.hpp"
+
+namespace {
+struct ErrorManager {
+    jpeg_error_mgr pub;
+    std::jmp_buf   jump;
+};
+
+auto error_exit(j_common_ptr cinfo) -> void {
+    std::longjmp(std::bit_cast<ErrorManager*>(cinfo->err)->jump, 1);
+}
+
+auto output_message(j_common_ptr /*cinfo*/) -> void {
+}
+
+// no objects with destructors may live between setjmp and longjmp, write everything to out
+auto decode(jpeg_decompress_struct& cinfo, ErrorManager& err, const std::span<const std::byte> data, const std::array<size_t, 2> box, ScaledImage& out) -> bool {
+    if(setjmp(err.jump) != 0) {
+        return false;
+    }
+    jpeg_mem_src(&cinfo, std::bit_cast<const unsigned char*>(data.data()), data.size());
+    if(jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        return false;
+    }
+    const auto fit   = fit_size(cinfo.image_width, cinfo.image_height, box);
+    auto       denom = 1u;
+    while(denom < 8 && cinfo.image_width / (denom * 2) >= fit[0] && cinfo.image_height / (denom * 2) >= fit[1]) {
+        denom *= 2;
+    }
+    if(denom == 1) {
+        return false;
+    }
+    cinfo.scale_num   = 1;
+    cinfo.scale_denom = denom;
+    cinfo.dct_method  = JDCT_IFAST;
+#ifdef JCS_EXTENSIONS
+    cinfo.out_color_space = JCS_EXT_RGBA;
+#else
+    cinfo.out_color_space = JCS_RGB;
+#endif
+    jpeg_start_decompress(&cinfo);
+
+    out.width       = cinfo.output_width;
+    out.height      = cinfo.output_height;
+    out.full_width  = cinfo.image_width;
+    out.full_height = cinfo.image_height;
+    out.data.resize(out.width * out.height * 4);
+    const auto stride = out.width * cinfo.output_components;
+    while(cinfo.output_scanline < cinfo.output_height) {
+        // decode into the tail of the row and expand in place if the library can not output rgba
+        const auto row = std::bit_cast<unsigned char*>(out.data.data()) + out.width * 4 * cinfo.output_scanline;
+        auto       dst = row + out.width * 4 - stride;
+        jpeg_read_scanlines(&cinfo, &dst, 1);
+        if(cinfo.output_components == 3) {
+            expand_rgb(std::bit_cast<const std::byte*>(dst), std::bit_cast<std::byte*>(row), out.width);
+        }
+    }
+    jpeg_finish_decompress(&cinfo);
+    return true;
+}
+} // namespace
+
+auto decode_jpeg_scaled(const std::span<const std::byte> data, const std::array<size_t, 2> box) -> std::optional<ScaledImage> {
+    if(data.size() < 3 || data[0] != std::byte(0xff) || data[1] != std::byte(0xd8) || data[2] != std::byte(0xff)) {
+        return std::nullopt;
+    }
+
+    auto cinfo = jpeg_decompress_struct();
+    auto err   = ErrorManager();
+    cinfo.err  = jpeg_std_error(&err.pub);
+
+    err.pub.error_exit     = error_exit;
+    err.pub.output_message = output_message;
+    jpeg_create_decompress(&cinfo);
+
+    auto out = ScaledImage();
+    auto ok  = decode(cinfo, err, data, box, out);
+    jpeg_destroy_decompress(&cinfo);
+    if(!ok) {
+        return std::nullopt;
+    }
+    return out;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <span>
+#include <vector>
+
+struct ScaledImage {
+    size_t                 width;
+    size_t                 height;
+    size_t                 full_width;
+    size_t                 full_height;
+    std::vector<std::byte> data; // rgba
+};
+
+// decodes a reduced image using dct scaling, which skips most of the idct work
+// the result is the smallest scale which still covers the image fitted into box
+// returns nullopt if the data is not a jpeg or the image is too small to benefit from it
+auto decode_jpeg_scaled(std::span<const std::byte> data, std::array<size_t, 2> box) -> std::optional<ScaledImage>;
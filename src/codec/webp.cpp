@@ -0,0 +1,68 @@
+#include <bit>
+#include <cstring>
+
+#include <webp/demux.h>
+
+#include "../macros/assert.hpp"
+#include "animation.hpp"
+
+namespace {
+class WebPDecoder : public AnimationDecoder {
+  private:
+    FileData         data;
+    WebPAnimDecoder* decoder;
+    WebPAnimInfo     info;
+    int              last_timestamp = 0;
+
+  public:
+    auto get_width() const -> size_t override {
+        return info.canvas_width;
+    }
+
+    auto get_height() const -> size_t override {
+        return info.canvas_height;
+    }
+
+    auto next() -> std::optional<Frame> override {
+        if(!WebPAnimDecoderHasMoreFrames(decoder)) {
+            WebPAnimDecoderReset(decoder);
+            last_timestamp = 0;
+        }
+        auto buffer    = (uint8_t*)(nullptr);
+        auto timestamp = 0;
+        ensure(WebPAnimDecoderGetNext(decoder, &buffer, &timestamp), "failed to decode webp frame");
+
+        auto frame     = Frame{std::vector<std::byte>(size_t(info.canvas_width) * info.canvas_height * 4), frame_duration(timestamp - last_timestamp)};
+        last_timestamp = timestamp;
+        std::memcpy(frame.pixels.data(), buffer, frame.pixels.size());
+        return frame;
+    }
+
+    WebPDecoder(FileData data, WebPAnimDecoder* const decoder, const WebPAnimInfo& info)
+        : data(std::move(data)),
+          decoder(decoder),
+          info(info) {}
+
+    ~WebPDecoder() {
+        WebPAnimDecoderDelete(decoder);
+    }
+};
+} // namespace
+
+auto open_webp(FileData data) -> std::unique_ptr<AnimationDecoder> {
+    auto options = WebPAnimDecoderOptions();
+    ensure(WebPAnimDecoderOptionsInit(&options));
+    options.color_mode  = MODE_RGBA;
+    options.use_threads = 0;
+
+    // the decoder references the bytes, which stay alive in data
+    const auto webp    = WebPData{std::bit_cast<const uint8_t*>(data.bytes.data()), data.bytes.size()};
+    const auto decoder = WebPAnimDecoderNew(&webp, &options);
+    ensure(decoder != nullptr);
+    auto info = WebPAnimInfo();
+    if(!WebPAnimDecoderGetInfo(decoder, &info) || info.frame_count <= 1) {
+        WebPAnimDecoderDelete(decoder);
+        return nullptr;
+    }
+    return std::unique_ptr<AnimationDecoder>(new WebPDecoder(std::move(data), decoder, info));
+}
@@ -0,0 +1,47 @@
+#include "config.hpp"
+#include "macros/unwrap.hpp"
+#include "util/charconv.hpp"
+
+auto parse_args(const int argc, const char* const argv[], Config& config) -> std::optional<std::vector<std::string_view>> {
+    auto ret = std::vector<std::string_view>();
+    for(auto i = 1; i < argc; i += 1) {
+        const auto arg = std::string_view(argv[i]);
+        if(!arg.starts_with("--")) {
+            ret.push_back(arg);
+            continue;
+        }
+        const auto sep   = arg.find('=');
+        const auto key   = arg.substr(2, sep == arg.npos ? arg.npos : sep - 2);
+        const auto value = sep == arg.npos ? std::string_view() : arg.substr(sep + 1);
+        if(key == "cache-budget") {
+            unwrap(mib, from_chars<size_t>(value), "invalid cache budget {}", value);
+            config.cache_budget = mib * 1024 * 1024;
+        } else if(key == "decode-to-screen") {
+            config.decode_to_screen = true;
+        } else if(key == "disk-cache") {
+            unwrap(mib, from_chars<size_t>(value), "invalid disk cache size {}", value);
+            config.disk_cache = mib * 1024 * 1024;
+        } else if(key == "trace") {
+            ensure(!value.empty(), "trace needs a path");
+            config.trace = value;
+        } else if(key == "readahead") {
+            unwrap(files, from_chars<size_t>(value), "invalid readahead window {}", value);
+            config.readahead = files;
+        } else if(key == "readahead-depth") {
+            unwrap(depth, from_chars<size_t>(value), "invalid readahead depth {}", value);
+            ensure(depth > 0, "readahead depth must be positive");
+            config.readahead_depth = depth;
+        } else if(key == "spread") {
+            if(value.empty() || value == "ltr") {
+                config.spread = Spread::LeftToRight;
+            } else if(value == "rtl") {
+                config.spread = Spread::RightToLeft;
+            } else {
+                bail("invalid spread direction {}", value);
+            }
+        } else {
+            bail("unknown option {}", arg);
+        }
+    }
+    return ret;
+}
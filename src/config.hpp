@@ -0,0 +1,24 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class Spread {
+    Off,
+    LeftToRight,
+    RightToLeft, // the first page on the right, for manga
+};
+
+struct Config {
+    size_t      cache_budget     = 512uz * 1024 * 1024; // bytes
+    bool        decode_to_screen = false;               // decode images reduced to the window size, load full resolution on zoom
+    size_t      disk_cache       = 0;                   // bytes of decoded pages kept under $XDG_CACHE_HOME, 0 to disable
+    std::string trace            = {};                  // chrome trace json written on exit and on E, empty to disable
+    Spread      spread           = Spread::Off;         // show two pages side by side, cycled with D
+    size_t      readahead        = 8;                   // files past the cached pages read into the kernel page cache, 0 to disable
+    size_t      readahead_depth  = 4;                   // reads in flight
+};
+
+// parses --key=value options and returns the remaining arguments
+auto parse_args(int argc, const char* const argv[], Config& config) -> std::optional<std::vector<std::string_view>>;
@@ -0,0 +1,38 @@
+#include "dir-index.hpp"
+#include "macros/unwrap.hpp"
+
+auto DirIndex::get(const std::string_view dir, const FileFilter filter) -> std::shared_ptr<const FileList> {
+    auto       ec    = std::error_code();
+    const auto mtime = std::filesystem::last_write_time(dir, ec);
+    ensure(!ec, "failed to stat {}: {}", dir, ec.message());
+
+    auto key = std::string(dir);
+    key.push_back('\0');
+    key.push_back(char('0' + int(filter)));
+
+    auto guard = std::lock_guard(lock);
+    tick += 1;
+    if(const auto it = entries.find(key); it != entries.end()) {
+        if(it->second.mtime == mtime) {
+            it->second.last_used = tick;
+            return it->second.list;
+        }
+        entries.erase(it);
+    }
+
+    unwrap_mut(list, list_files(dir, filter));
+
+    if(entries.size() >= max_entries) {
+        auto oldest = entries.begin();
+        for(auto it = entries.begin(); it != entries.end(); it = std::next(it)) {
+            if(it->second.last_used < oldest->second.last_used) {
+                oldest = it;
+            }
+        }
+        entries.erase(oldest);
+    }
+
+    auto ptr = std::make_shared<const FileList>(std::move(list));
+    entries.emplace(std::move(key), Entry{ptr, mtime, tick});
+    return ptr;
+}
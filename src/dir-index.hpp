@@ -0,0 +1,28 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "file-list.hpp"
+
+// memoizes sorted and filtered directory listings
+// entries are revalidated with the directory mtime, so a hit costs one stat instead of a directory read
+// thread safe, the prefetcher resolves neighbor works from a blocking thread
+class DirIndex {
+  private:
+    struct Entry {
+        std::shared_ptr<const FileList> list;
+        std::filesystem::file_time_type mtime;
+        size_t                          last_used;
+    };
+
+    std::mutex                             lock;
+    std::unordered_map<std::string, Entry> entries;
+    size_t                                 tick = 0;
+
+    constexpr static auto max_entries = 256uz;
+
+  public:
+    auto get(std::string_view dir, FileFilter filter) -> std::shared_ptr<const FileList>;
+};
@@ -0,0 +1,76 @@
+#include <bit>
+#include <utility>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "dir-watcher.hpp"
+#include "macros/assert.hpp"
+
+auto DirWatcher::open() -> std::optional<DirWatcher> {
+    auto watcher = DirWatcher();
+    watcher.fd   = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    ensure(watcher.fd >= 0, "failed to initialize inotify");
+    return watcher;
+}
+
+auto DirWatcher::set_dir(const std::filesystem::path& dir) -> bool {
+    unset_dir();
+    // new files are reported once written, so that half written pages are not loaded
+    constexpr auto mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR;
+    watch               = inotify_add_watch(fd, dir.c_str(), mask);
+    ensure(watch >= 0, "failed to watch {}", dir.string());
+    return true;
+}
+
+auto DirWatcher::unset_dir() -> void {
+    if(watch >= 0) {
+        inotify_rm_watch(fd, watch);
+        watch = -1;
+    }
+}
+
+auto DirWatcher::read() -> std::optional<std::vector<Event>> {
+    auto events   = std::vector<Event>();
+    auto overflow = false;
+    alignas(inotify_event) char buffer[4096];
+loop:
+    const auto len = ::read(fd, buffer, sizeof(buffer));
+    if(len <= 0) {
+        if(overflow) {
+            return std::nullopt;
+        }
+        return events;
+    }
+    for(auto pos = 0uz; pos < size_t(len);) {
+        const auto event = std::bit_cast<const inotify_event*>(buffer + pos);
+        pos             += sizeof(inotify_event) + event->len;
+        if(event->mask & IN_Q_OVERFLOW) {
+            // keep draining, the queued events are superseded by the listing
+            overflow = true;
+            continue;
+        }
+        // events of a previous directory may still be queued
+        if(event->wd != watch || event->len == 0 || (event->mask & IN_ISDIR)) {
+            continue;
+        }
+        events.push_back(Event{event->name, (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0});
+    }
+    goto loop;
+}
+
+DirWatcher::DirWatcher(DirWatcher&& o)
+    : fd(std::exchange(o.fd, -1)),
+      watch(std::exchange(o.watch, -1)) {}
+
+auto DirWatcher::operator=(DirWatcher&& o) -> DirWatcher& {
+    std::swap(fd, o.fd);
+    std::swap(watch, o.watch);
+    return *this;
+}
+
+DirWatcher::~DirWatcher() {
+    if(fd >= 0) {
+        close(fd);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// reports files appearing in and disappearing from one directory at a time
+class DirWatcher {
+  public:
+    struct Event {
+        std::string name;
+        bool        added; // finished writing or moved in, otherwise deleted or moved out
+    };
+
+  private:
+    int fd    = -1;
+    int watch = -1;
+
+  public:
+    static auto open() -> std::optional<DirWatcher>;
+
+    // replaces the watched directory, events of the previous one are no longer reported
+    auto set_dir(const std::filesystem::path& dir) -> bool;
+    auto unset_dir() -> void;
+    // readable when events are pending
+    auto get_fd() const -> int {
+        return fd;
+    }
+    // pending events, does not block
+    // nullopt if the kernel queue overflowed and events were lost, the directory has to be listed again
+    auto read() -> std::optional<std::vector<Event>>;
+
+    DirWatcher() = default;
+    DirWatcher(DirWatcher&& o);
+    auto operator=(DirWatcher&& o) -> DirWatcher&;
+    ~DirWatcher();
+};
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "disk-cache.hpp"
+#include "macros/assert.hpp"
+
+namespace {
+constexpr auto magic = std::array{'i', 'm', 'g', 'v', 'c', 'c', '0', '1'};
+
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t            width;
+    uint32_t            height;
+    double              ratio;
+    uint32_t            key_size; // followed by the key, then pixels
+    uint32_t            reserved;
+};
+
+auto fnv1a(const std::string_view data) -> uint64_t {
+    auto hash = uint64_t(0xcbf29ce484222325);
+    for(const auto c : data) {
+        hash ^= uint8_t(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+} // namespace
+
+auto DiskCache::entry_path(const Key& key) const -> std::filesystem::path {
+    return root / std::format("{:016x}", fnv1a(key.data));
+}
+
+auto DiskCache::evict() -> void {
+    // rescan, someone else may share the directory
+    struct Entry {
+        std::filesystem::path           path;
+        std::filesystem::file_time_type time;
+        size_t                          size;
+    };
+    auto entries = std::vector<Entry>();
+    auto total   = 0uz;
+    auto ec      = std::error_code();
+    for(const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+        const auto size = entry.file_size(ec);
+        const auto time = entry.last_write_time(ec);
+        if(!ec) {
+            entries.push_back({entry.path(), time, size});
+            total += size;
+        }
+    }
+    used = total;
+    if(total <= capacity) {
+        return;
+    }
+
+    // oldest first, until well below the cap so that we do not rescan on every store
+    std::ranges::sort(entries, {}, &Entry::time);
+    const auto target = capacity / 4 * 3;
+    for(const auto& entry : entries) {
+        if(*used <= target) {
+            break;
+        }
+        if(std::filesystem::remove(entry.path, ec)) {
+            *used -= entry.size;
+        }
+    }
+}
+
+auto DiskCache::make_key(const std::filesystem::path& path, const std::string_view variant) -> std::optional<Key> {
+    struct stat st{};
+    ensure(stat(path.c_str(), &st) == 0);
+    return Key{std::format("{}\n{}\n{}.{}\n{}", path.string(), st.st_size, st.st_mtim.tv_sec, st.st_mtim.tv_nsec, variant)};
+}
+
+auto DiskCache::load(const Key& key) -> std::optional<Image> {
+    const auto path = entry_path(key);
+    auto       ec   = std::error_code();
+    if(!std::filesystem::exists(path, ec)) {
+        return std::nullopt;
+    }
+    auto file = MappedFile::open(path.c_str());
+    ensure(file);
+    const auto data = file->get();
+    ensure(data.size() >= sizeof(Header));
+    auto header = Header();
+    std::memcpy(&header, data.data(), sizeof(Header));
+    ensure(header.magic == magic);
+    ensure(data.size() >= sizeof(Header) + header.key_size);
+    // hash collision
+    ensure(std::string_view(std::bit_cast<const char*>(data.data() + sizeof(Header)), header.key_size) == key.data);
+    const auto offset = sizeof(Header) + header.key_size;
+    ensure(data.size() == offset + size_t(header.width) * header.height * 4);
+
+    // mark as recently used
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+    const auto pixels = data.data() + offset;
+    return Image{std::move(*file), pixels, header.width, header.height, header.ratio};
+}
+
+auto DiskCache::store(const Key& key, const std::byte* const pixels, const size_t width, const size_t height, const double ratio) -> bool {
+    const auto bytes = sizeof(Header) + key.data.size() + width * height * 4;
+    if(bytes > capacity / 8) {
+        // would flush too much of the cache
+        return false;
+    }
+
+    // write to a temporary file and rename it, so that readers never see partial entries
+    // the name is unique across threads and processes sharing the directory
+    static auto serial = std::atomic_size_t(0);
+    const auto  path   = entry_path(key);
+    const auto  temp   = std::filesystem::path(path).concat(std::format(".{}.{}.tmp", getpid(), serial.fetch_add(1)));
+    {
+        auto out    = std::ofstream(temp, std::ios::binary);
+        auto header = Header{magic, uint32_t(width), uint32_t(height), ratio, uint32_t(key.data.size()), 0};
+        out.write(std::bit_cast<const char*>(&header), sizeof(header));
+        out.write(key.data.data(), key.data.size());
+        out.write(std::bit_cast<const char*>(pixels), width * height * 4);
+        if(!out) {
+            auto ec = std::error_code();
+            std::filesystem::remove(temp, ec);
+            bail("failed to write {}", temp.string());
+        }
+    }
+    auto ec = std::error_code();
+    std::filesystem::rename(temp, path, ec);
+    ensure(!ec, "failed to rename {}: {}", temp.string(), ec.message());
+
+    const auto guard = std::lock_guard(lock);
+    if(!used) {
+        evict();
+    } else if((*used += bytes) > capacity) {
+        evict();
+    }
+    return true;
+}
+
+auto DiskCache::default_root() -> std::optional<std::filesystem::path> {
+    if(const auto xdg = getenv("XDG_CACHE_HOME"); xdg != nullptr && xdg[0] != '\0') {
+        return std::filesystem::path(xdg) / "imgview";
+    }
+    const auto home = getenv("HOME");
+    ensure(home != nullptr, "neither XDG_CACHE_HOME nor HOME is set");
+    return std::filesystem::path(home) / ".cache" / "imgview";
+}
+
+DiskCache::DiskCache(std::filesystem::path root, const size_t capacity)
+    : root(std::move(root)),
+      capacity(capacity) {}
@@ -0,0 +1,46 @@
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "mapped-file.hpp"
+
+// persistent cache of decoded pixels
+// entries are keyed by source path, size and mtime, the least recently used ones are removed beyond the size cap
+class DiskCache {
+  public:
+    // identifies a source file, plus a variant such as the decoded size
+    struct Key {
+        std::string data;
+    };
+
+    struct Image {
+        MappedFile       file;
+        const std::byte* pixels; // rgba, valid while file is alive
+        size_t           width;
+        size_t           height;
+        double           ratio; // source size / stored size
+    };
+
+  private:
+    std::filesystem::path root;
+    size_t                capacity;
+    std::mutex            lock;
+    std::optional<size_t> used; // scanned on first store
+
+    auto entry_path(const Key& key) const -> std::filesystem::path;
+    auto evict() -> void;
+
+  public:
+    // returns nullopt if the file cannot be stat'ed
+    static auto make_key(const std::filesystem::path& path, std::string_view variant) -> std::optional<Key>;
+
+    auto load(const Key& key) -> std::optional<Image>;
+    auto store(const Key& key, const std::byte* pixels, size_t width, size_t height, double ratio) -> bool;
+
+    // $XDG_CACHE_HOME/imgview, or ~/.cache/imgview
+    static auto default_root() -> std::optional<std::filesystem::path>;
+
+    DiskCache(std::filesystem::path root, size_t capacity);
+};
@@ -0,0 +1,66 @@
+#include "animation.hpp"
+
+auto Animation::fill() -> bool {
+    while(true) {
+        {
+            const auto guard = std::lock_guard(lock);
+            if(ring.size() >= ring_size) {
+                return true;
+            }
+        }
+        auto frame = decoder->next();
+        if(!frame) {
+            return false;
+        }
+        const auto guard = std::lock_guard(lock);
+        ring.push_back(std::move(*frame));
+    }
+}
+
+auto Animation::get_deadline() -> Clock::time_point {
+    if(!deadline) {
+        deadline = Clock::now() + duration;
+    }
+    return *deadline;
+}
+
+auto Animation::advance(const Clock::time_point now) -> bool {
+    const auto expire = get_deadline();
+    if(now < expire) {
+        return false;
+    }
+    const auto guard = std::lock_guard(lock);
+    if(ring.empty()) {
+        // decoding is behind
+        return false;
+    }
+    due = std::move(ring.front());
+    ring.pop_front();
+    duration = due->duration;
+    // keep the pace, unless we are so late that catching up would skip frames
+    deadline = now - expire > duration ? now + duration : expire + duration;
+    return true;
+}
+
+auto Animation::draw(gawl::Screen& screen, const gawl::Rectangle& rect) -> bool {
+    if(due) {
+        graphic = gawl::Graphic(gawl::PixelBuffer::from_raw(width, height, std::move(due->pixels)));
+        due.reset();
+    }
+    if(!graphic) {
+        return false;
+    }
+    graphic.draw_rect(screen, rect);
+    return true;
+}
+
+auto Animation::get_size() const -> size_t {
+    // ring, the due frame and the shown one
+    return width * height * 4 * (ring_size + 2);
+}
+
+Animation::Animation(std::unique_ptr<AnimationDecoder> decoder, const std::chrono::milliseconds first_duration)
+    : decoder(std::move(decoder)),
+      width(this->decoder->get_width()),
+      height(this->decoder->get_height()),
+      duration(first_duration) {}
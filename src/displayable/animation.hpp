@@ -0,0 +1,41 @@
+#pragma once
+#include <deque>
+#include <mutex>
+
+#include "../codec/animation.hpp"
+#include "../gawl/graphic.hpp"
+
+// frames are decoded a few ahead into a ring by the player and swapped in when they are due
+// only the ring and the shown frame are kept in memory, regardless of the animation length
+class Animation {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  private:
+    std::unique_ptr<AnimationDecoder> decoder; // only used by fill
+    size_t                            width;
+    size_t                            height;
+    std::mutex                        lock; // guards ring
+    std::deque<Frame>                 ring;
+    std::optional<Frame>              due; // waiting for upload on the next draw
+    gawl::Graphic                     graphic;
+    std::chrono::milliseconds         duration; // of the shown frame
+    std::optional<Clock::time_point>  deadline; // when the shown frame expires, unset until playback starts
+
+  public:
+    constexpr static auto ring_size = 3uz;
+
+    // decodes until the ring is full, called from a blocking thread
+    auto fill() -> bool;
+    // when the shown frame expires
+    auto get_deadline() -> Clock::time_point;
+    // swaps in the next frame if the shown one expired, returns true if a redraw is needed
+    auto advance(Clock::time_point now) -> bool;
+    // returns false until the first swapped in frame is drawn
+    auto draw(gawl::Screen& screen, const gawl::Rectangle& rect) -> bool;
+    // bytes held at most
+    auto get_size() const -> size_t;
+
+    // first_duration: duration of the frame already shown as the still image
+    Animation(std::unique_ptr<AnimationDecoder> decoder, std::chrono::milliseconds first_duration);
+};
@@ -1,19 +1,72 @@
 #pragma once
-#include <string_view>
+#include <span>
+
+#include "../disk-cache.hpp"
+#include "../file-data.hpp"
+#include "../trace.hpp"
 
 #include "../gawl/screen.hpp"
 
 struct DrawParameters {
+    enum class Side {
+        Whole,
+        Left,  // left page of a spread, fit into the left half against the middle
+        Right, // right page of a spread
+    };
+
     int    screen_size[2];
     double offset[2];
     double scale;
+    Side   side = Side::Whole;
 };
 
+class Animation;
+
 struct Displayable {
-    bool loaded = false;
+    enum class State {
+        Loading,
+        Preview, // a reduced version is drawable, the full one is still loading
+        Loaded,
+    };
+
+    State state       = State::Loading;
+    bool  reduced     = false; // decoded smaller than the source, the full resolution can be loaded on demand
+    bool  keep_pixels = false; // upload leaves the decoded pixels for store
+
+    PageTiming timing = {}; // how the page was loaded
 
-    virtual auto load(std::string_view path) -> bool                              = 0;
+    // cpu work, called from a decoder thread
+    // data stays alive as long as the displayable keeps a reference to it
+    virtual auto decode(const FileData& data) -> bool = 0;
+    // gpu work, called from the uploader thread with a gl context
+    virtual auto upload() -> bool {
+        return true;
+    }
+    // optional quick decode drawn until the full one is loaded, returns false if not available
+    virtual auto decode_preview(std::span<const std::byte> /*data*/) -> bool {
+        return false;
+    }
+    virtual auto upload_preview() -> bool {
+        return true;
+    }
+    // load the decoded page from the disk cache instead of decoding, called from a blocking thread
+    virtual auto restore(DiskCache& /*cache*/, const std::filesystem::path& /*path*/) -> bool {
+        return false;
+    }
+    // save the decoded page, called from a blocking thread after upload if keep_pixels is set
+    // releases the pixels kept for it
+    virtual auto store(DiskCache& /*cache*/, const std::filesystem::path& /*path*/) -> void {}
+    // memory held by the decoded page
+    virtual auto get_size() const -> size_t                                       = 0;
     virtual auto draw(gawl::Screen* screen, const DrawParameters& params) -> void = 0;
+    // whether the last draw left work for the following frames, the caller then draws again
+    virtual auto needs_redraw() const -> bool {
+        return false;
+    }
+    // animated pages are played by the caller
+    virtual auto get_animation() -> Animation* {
+        return nullptr;
+    }
     virtual auto zoom_by_drag(gawl::Screen* /*screen*/, const gawl::Point& /*clicked*/, double /*value*/, DrawParameters& /*params*/) -> void{};
 
     virtual ~Displayable() {}
@@ -1,37 +1,183 @@
+#include <format>
+
 #include "image.hpp"
+#include "../codec/animation.hpp"
+#include "../codec/jpeg.hpp"
 #include "../gawl/misc.hpp"
 #include "../macros/unwrap.hpp"
+#include "../resample.hpp"
 
 namespace {
-auto calc_draw_area(const gawl::Graphic& graphic, gawl::Screen* const screen, const DrawParameters& params) -> gawl::Rectangle {
-    const auto size = std::array{graphic.get_width(*screen), graphic.get_height(*screen)};
-    auto       area = gawl::calc_fit_rect({{0, 0}, {1. * params.screen_size[0], 1. * params.screen_size[1]}}, size[0], size[1]);
+constexpr auto preview_size = 1024uz;
+
+auto calc_draw_area(const gawl::Graphic& graphic, gawl::Screen* const screen, const DrawParameters& params, const double ratio = 1.0) -> gawl::Rectangle {
+    using Side = DrawParameters::Side;
+
+    const auto size   = std::array{graphic.get_width(*screen) * ratio, graphic.get_height(*screen) * ratio};
+    const auto width  = 1. * params.screen_size[0];
+    const auto height = 1. * params.screen_size[1];
+    const auto middle = width / 2;
+    const auto box    = params.side == Side::Left    ? gawl::Rectangle{{0, 0}, {middle, height}}
+                        : params.side == Side::Right ? gawl::Rectangle{{middle, 0}, {width, height}}
+                                                     : gawl::Rectangle{{0, 0}, {width, height}};
+    auto       area   = gawl::calc_fit_rect(box, size[0], size[1]);
+    // spread pages meet at the middle and grow outward from it
+    const auto shift  = params.side == Side::Left ? middle - area.b.x : params.side == Side::Right ? middle - area.a.x : 0.0;
+    area.a.x         += shift;
+    area.b.x         += shift;
     for(auto i = 0; i < 2; i += 1) {
-        const auto exp = size[i] * params.scale / 2;
-        (i == 0 ? area.a.x : area.a.y) += params.offset[i] - exp;
-        (i == 0 ? area.b.x : area.b.y) += params.offset[i] + exp;
+        const auto exp    = size[i] * params.scale / 2;
+        const auto before = i == 0 && params.side == Side::Right ? 0.0 : i == 0 && params.side == Side::Left ? exp * 2 : exp;
+        const auto after  = exp * 2 - before;
+        (i == 0 ? area.a.x : area.a.y) += params.offset[i] - before;
+        (i == 0 ? area.b.x : area.b.y) += params.offset[i] + after;
     }
     return area;
 }
+
+auto make_key(const std::filesystem::path& path, const std::array<size_t, 2>& fit_box) -> std::optional<DiskCache::Key> {
+    return DiskCache::make_key(path, std::format("image {}x{}", fit_box[0], fit_box[1]));
+}
 } // namespace
 
-auto DisplayableImage::load(const std::string_view path) -> bool {
-    unwrap(pixbuf, gawl::PixelBuffer::from_file(std::string(path).data()));
+auto DisplayableImage::decode(const FileData& file) -> bool {
+    if(auto decoder = open_animation(file)) {
+        if(file.mapped) {
+            // frames are decoded for as long as the page is shown, keep a copy rather than the mapping
+            auto copy = std::make_shared<std::vector<std::byte>>(file.bytes.begin(), file.bytes.end());
+            decoder   = open_animation(FileData{copy, *copy});
+            ensure(decoder);
+        }
+        const auto width  = decoder->get_width();
+        const auto height = decoder->get_height();
+        unwrap_mut(first, decoder->next());
+        pixbuf    = gawl::PixelBuffer::from_raw(width, height, std::move(first.pixels));
+        animation = std::make_unique<Animation>(std::move(decoder), first.duration);
+        size      = width * height * 4 + animation->get_size();
+        return true;
+    }
+
+    const auto data = file.bytes;
+    if(fit_box[0] == 0) {
+        unwrap_mut(buf, gawl::PixelBuffer::from_blob(data.data(), data.size()));
+        if(TiledImage::needs_tiling(buf.get_width(), buf.get_height())) {
+            const auto width = buf.get_width();
+            tiled            = std::make_unique<TiledImage>(std::move(buf));
+            pixbuf           = tiled->get_coarsest();
+            image_ratio      = double(width) / pixbuf.get_width();
+            size             = tiled->get_size() + pixbuf.get_width() * pixbuf.get_height() * 4;
+            return true;
+        }
+        pixbuf = std::move(buf);
+    } else if(auto scaled = decode_jpeg_scaled(data, fit_box)) {
+        const auto fit = fit_size(scaled->full_width, scaled->full_height, fit_box);
+        image_ratio    = double(scaled->full_width) / fit[0];
+        reduced        = true;
+        if(fit[0] != scaled->width || fit[1] != scaled->height) {
+            scaled->data = downscale(scaled->data.data(), scaled->width, scaled->height, fit[0], fit[1]);
+        }
+        pixbuf = gawl::PixelBuffer::from_raw(fit[0], fit[1], std::move(scaled->data));
+    } else {
+        unwrap_mut(buf, gawl::PixelBuffer::from_blob(data.data(), data.size()));
+        const auto fit = fit_size(buf.get_width(), buf.get_height(), fit_box);
+        if(fit[0] != buf.get_width() || fit[1] != buf.get_height()) {
+            image_ratio = double(buf.get_width()) / fit[0];
+            reduced     = true;
+            buf         = gawl::PixelBuffer::from_raw(fit[0], fit[1], downscale(buf.get_buffer(), buf.get_width(), buf.get_height(), fit[0], fit[1]));
+        }
+        pixbuf = std::move(buf);
+    }
+    size = pixbuf.get_width() * pixbuf.get_height() * 4;
+    return true;
+}
+
+auto DisplayableImage::upload() -> bool {
     image = gawl::Graphic(pixbuf);
+    if(!keep_pixels) {
+        pixbuf.clear();
+    }
+    return true;
+}
+
+auto DisplayableImage::decode_preview(const std::span<const std::byte> data) -> bool {
+    if(fit_box[0] != 0) {
+        // already decoding a reduced image
+        return false;
+    }
+    unwrap_mut(scaled, decode_jpeg_scaled(data, {preview_size, preview_size}));
+    preview_ratio  = double(scaled.full_width) / scaled.width;
+    preview_pixbuf = gawl::PixelBuffer::from_raw(scaled.width, scaled.height, std::move(scaled.data));
+    return true;
+}
+
+auto DisplayableImage::upload_preview() -> bool {
+    preview = gawl::Graphic(preview_pixbuf);
+    preview_pixbuf.clear();
     return true;
 }
 
+auto DisplayableImage::restore(DiskCache& cache, const std::filesystem::path& path) -> bool {
+    unwrap(key, make_key(path, fit_box));
+    unwrap(entry, cache.load(key));
+    pixbuf      = gawl::PixelBuffer::from_raw(entry.width, entry.height, entry.pixels);
+    image_ratio = entry.ratio;
+    reduced     = entry.ratio != 1.0;
+    size        = entry.width * entry.height * 4;
+    return true;
+}
+
+auto DisplayableImage::store(DiskCache& cache, const std::filesystem::path& path) -> void {
+    // too large to be worth caching, or not a still image
+    if(!tiled && !animation) {
+        if(const auto key = make_key(path, fit_box)) {
+            cache.store(*key, pixbuf.get_buffer(), pixbuf.get_width(), pixbuf.get_height(), image_ratio);
+        }
+    }
+    pixbuf.clear();
+}
+
+auto DisplayableImage::get_size() const -> size_t {
+    return size;
+}
+
 auto DisplayableImage::draw(gawl::Screen* const screen, const DrawParameters& params) -> void {
-    const auto rect = calc_draw_area(image, screen, params);
+    if(state == State::Preview) {
+        const auto rect = calc_draw_area(preview, screen, params, preview_ratio);
+        preview.draw_rect(*screen, rect);
+        return;
+    }
+    if(preview) {
+        // the preview may be drawn until the state changes, so release it on the render thread
+        preview = gawl::Graphic();
+    }
+    const auto rect = calc_draw_area(image, screen, params, image_ratio);
+    if(animation && animation->draw(*screen, rect)) {
+        return;
+    }
+    if(tiled) {
+        tiles_pending = !tiled->draw(*screen, rect, params.screen_size, image);
+        return;
+    }
     image.draw_rect(*screen, rect);
 }
 
+auto DisplayableImage::needs_redraw() const -> bool {
+    return tiles_pending;
+}
+
+auto DisplayableImage::get_animation() -> Animation* {
+    return animation.get();
+}
+
 auto DisplayableImage::zoom_by_drag(gawl::Screen* screen, const gawl::Point& clicked, const double value, DrawParameters& params) -> void {
-    const auto   area     = calc_draw_area(image, screen, params);
-    const auto   delta    = std::array{image.get_width(*screen) * value, image.get_height(*screen) * value};
+    const auto   area     = calc_draw_area(image, screen, params, image_ratio);
+    const auto   delta    = std::array{image.get_width(*screen) * image_ratio * value, image.get_height(*screen) * image_ratio * value};
     const double center_x = area.a.x + area.width() / 2;
     const double center_y = area.a.y + area.height() / 2;
     params.offset[0] += (center_x - clicked.x) / area.width() * delta[0];
     params.offset[1] += (center_y - clicked.y) / area.height() * delta[1];
     params.scale += value;
 }
+
+DisplayableImage::DisplayableImage(const std::array<size_t, 2> fit_box)
+    : fit_box(fit_box) {}
@@ -1,10 +1,36 @@
+#include <memory>
+
 #include "../gawl/graphic.hpp"
+#include "animation.hpp"
 #include "displayable.hpp"
+#include "tiled-image.hpp"
 
 struct DisplayableImage : Displayable {
-    gawl::Graphic image;
+    std::array<size_t, 2> fit_box; // decode reduced to fit in this box, {0, 0} for full resolution
+    gawl::PixelBuffer     pixbuf;
+    gawl::Graphic         image;
+    double                image_ratio = 1.0; // source size / texture size
+    size_t                size        = 0;
+    gawl::PixelBuffer     preview_pixbuf;
+    gawl::Graphic         preview;
+    double                preview_ratio; // source size / preview size
+    // set for images too large for a single texture, image then holds the coarsest level
+    std::unique_ptr<TiledImage> tiled;
+    bool                        tiles_pending = false; // the last draw left tiles to upload
+    // set for animations, image then holds the first frame
+    std::unique_ptr<Animation> animation;
 
-    auto load(std::string_view path) -> bool override;
+    auto decode(const FileData& data) -> bool override;
+    auto upload() -> bool override;
+    auto decode_preview(std::span<const std::byte> data) -> bool override;
+    auto upload_preview() -> bool override;
+    auto restore(DiskCache& cache, const std::filesystem::path& path) -> bool override;
+    auto store(DiskCache& cache, const std::filesystem::path& path) -> void override;
+    auto get_size() const -> size_t override;
     auto draw(gawl::Screen* screen, const DrawParameters& params) -> void override;
+    auto needs_redraw() const -> bool override;
+    auto get_animation() -> Animation* override;
     auto zoom_by_drag(gawl::Screen* screen, const gawl::Point& from, double value, DrawParameters& params) -> void override;
+
+    DisplayableImage(std::array<size_t, 2> fit_box = {0, 0});
 };
@@ -1,34 +1,104 @@
-#include <fstream>
+#include <algorithm>
+#include <bit>
 
 #include "../gawl/misc.hpp"
-#include "../macros/assert.hpp"
 #include "text.hpp"
 
-auto DisplayableText::load(const std::string_view path) -> bool {
-    auto in = std::ifstream();
-    try {
-        in.open(path, std::ios::binary);
-    } catch(const std::runtime_error& e) {
-        bail("filesystem error: {}", e.what());
+namespace {
+constexpr auto font_size    = 16;
+constexpr auto line_spacing = font_size * 1.3;
+} // namespace
+
+auto DisplayableText::index_paragraphs() -> void {
+    paragraphs.clear();
+    for(auto pos = 0uz; pos < text.size();) {
+        paragraphs.push_back(pos);
+        const auto end = text.find('\n', pos);
+        if(end == std::string::npos) {
+            break;
+        }
+        pos = end + 1;
     }
+}
+
+auto DisplayableText::get_paragraph(const size_t index) const -> std::string_view {
+    const auto begin = paragraphs[index];
+    const auto end   = index + 1 < paragraphs.size() ? paragraphs[index + 1] - 1 : text.size();
+    auto       line  = std::string_view(text).substr(begin, end - begin);
+    if(line.ends_with('\r')) {
+        line.remove_suffix(1);
+    }
+    return line;
+}
 
-    text = std::string(std::istreambuf_iterator<char>(in), {});
+auto DisplayableText::measure_until(gawl::Screen& screen, const double y) -> void {
+    while(bottoms.size() < paragraphs.size() && (bottoms.empty() ? 0. : bottoms.back()) < y) {
+        // kept for draw, so that the paragraph is not shaped again
+        auto&      wrapped = caches[bottoms.size()];
+        const auto height  = font->calc_wrapped_text_height(screen, layout_width, line_spacing, get_paragraph(bottoms.size()), wrapped, font_size);
+        // empty lines still take a line
+        bottoms.push_back((bottoms.empty() ? 0. : bottoms.back()) + std::max(height, line_spacing));
+    }
+}
+
+auto DisplayableText::decode(const FileData& data) -> bool {
+    text = std::string(std::bit_cast<const char*>(data.bytes.data()), data.bytes.size());
+    index_paragraphs();
     return true;
 }
 
+auto DisplayableText::get_size() const -> size_t {
+    return text.size() + paragraphs.size() * sizeof(size_t);
+}
+
 auto DisplayableText::draw(gawl::Screen* const screen, const DrawParameters& params) -> void {
-    constexpr auto font_size = 16;
+    // a page of a spread gets its half of the screen
+    const auto half  = params.side != DrawParameters::Side::Whole;
+    const auto left  = params.side == DrawParameters::Side::Right ? params.screen_size[0] / 2. : 0.;
+    const auto width = half ? params.screen_size[0] / 2. : 1. * params.screen_size[0];
+    if(width != layout_width) {
+        layout_width = width;
+        bottoms.clear();
+        caches.clear();
+    }
 
-    const auto content_height = font->calc_wrapped_text_height(*screen, params.screen_size[0], font_size * 1.3, text, cache, font_size);
-    const auto rect           = gawl::Rectangle{{0, params.offset[1]}, {1. * params.screen_size[0], params.offset[1] + content_height}};
+    // visible range in content coordinates, lay out one more screen so that scrolling down finds it ready
+    const auto view_top    = -params.offset[1];
+    const auto view_bottom = view_top + params.screen_size[1];
+    const auto lookahead   = view_bottom + params.screen_size[1];
+    measure_until(*screen, lookahead);
+
+    const auto top_of = [this](const size_t i) { return i == 0 ? 0. : bottoms[i - 1]; };
+    const auto first  = size_t(std::ranges::upper_bound(bottoms, view_top) - bottoms.begin());
+    auto       last   = first;
+    while(last < bottoms.size() && top_of(last) < view_bottom) {
+        last += 1;
+    }
+    // layouts below the view stay, they were just made by measure_until
+    auto keep = last;
+    while(keep < bottoms.size() && top_of(keep) < lookahead) {
+        keep += 1;
+    }
+    std::erase_if(caches, [first, keep](const auto& entry) { return entry.first < first || entry.first >= keep; });
+    if(first == last) {
+        return;
+    }
 
+    const auto rect = gawl::Rectangle{{left, params.offset[1] + top_of(first)}, {left + width, params.offset[1] + bottoms[last - 1]}};
     gawl::draw_rect(*screen, rect, {0, 0, 0, 0.6});
     gawl::mask_alpha();
-    font->draw_wrapped(*screen, rect, font_size * 1.3, {1, 1, 1, 1}, text, cache, {
-                                                                                      .size    = font_size,
-                                                                                      .align_x = gawl::Align::Left,
-                                                                                      .align_y = gawl::Align::Left,
-                                                                                  });
+    for(auto i = first; i < last; i += 1) {
+        const auto paragraph = get_paragraph(i);
+        if(paragraph.empty()) {
+            continue;
+        }
+        const auto area = gawl::Rectangle{{left, params.offset[1] + top_of(i)}, {left + width, params.offset[1] + bottoms[i]}};
+        font->draw_wrapped(*screen, area, line_spacing, {1, 1, 1, 1}, paragraph, caches[i], {
+                                                                                              .size    = font_size,
+                                                                                              .align_x = gawl::Align::Left,
+                                                                                              .align_y = gawl::Align::Left,
+                                                                                          });
+    }
     gawl::unmask_alpha();
 }
 
@@ -36,4 +106,6 @@ DisplayableText::DisplayableText(gawl::TextRender& font)
     : font(&font) {}
 
 DisplayableText::DisplayableText(gawl::TextRender& font, std::string text)
-    : font(&font), text(std::move(text)) {}
+    : font(&font), text(std::move(text)) {
+    index_paragraphs();
+}
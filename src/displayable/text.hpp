@@ -1,12 +1,25 @@
+#include <unordered_map>
+
 #include "../gawl/textrender.hpp"
 #include "displayable.hpp"
 
 struct DisplayableText : Displayable {
-    gawl::TextRender* font;
-    std::string       text;
-    gawl::WrappedText cache;
+    gawl::TextRender*   font;
+    std::string         text;
+    std::vector<size_t> paragraphs; // offset of every line in text, built by decode
+
+    // wrapped layout for layout_width, render thread only
+    // paragraphs are measured in order up to a screen below the view, so only what has been scrolled through is laid out
+    double                                        layout_width = -1;
+    std::vector<double>                           bottoms; // bottom of each measured paragraph
+    std::unordered_map<size_t, gawl::WrappedText> caches;  // paragraphs in or a screen below the view, filled by measure_until and draw
+
+    auto index_paragraphs() -> void;
+    auto get_paragraph(size_t index) const -> std::string_view;
+    auto measure_until(gawl::Screen& screen, double y) -> void;
 
-    auto load(std::string_view path) -> bool override;
+    auto decode(const FileData& data) -> bool override;
+    auto get_size() const -> size_t override;
     auto draw(gawl::Screen* screen, const DrawParameters& params) -> void override;
 
     DisplayableText(gawl::TextRender& font);
@@ -0,0 +1,147 @@
+#include <cmath>
+
+#include "../resample.hpp"
+#include "tiled-image.hpp"
+
+namespace {
+constexpr auto threshold   = 8192uz; // conservative GL_MAX_TEXTURE_SIZE
+constexpr auto margin      = 1uz;    // tiles uploaded around the viewport ahead of panning
+constexpr auto max_uploads = 2uz;    // per frame, a tile is 4MiB
+
+auto tile_key(const size_t level, const size_t x, const size_t y) -> uint64_t {
+    return uint64_t(level) << 48 | uint64_t(y) << 24 | uint64_t(x);
+}
+} // namespace
+
+auto TiledImage::upload_tile(const size_t level, const size_t x, const size_t y) const -> gawl::Graphic {
+    const auto& l      = levels[level];
+    const auto  left   = x * tile_size;
+    const auto  top    = y * tile_size;
+    const auto  width  = std::min(tile_size, l.width - left);
+    const auto  height = std::min(tile_size, l.height - top);
+
+    auto buffer = std::vector<std::byte>(width * height * 4);
+    for(auto row = 0uz; row < height; row += 1) {
+        const auto src = l.pixels + ((top + row) * l.width + left) * 4;
+        std::copy(src, src + width * 4, buffer.data() + row * width * 4);
+    }
+    return gawl::Graphic(gawl::PixelBuffer::from_raw(width, height, std::move(buffer)));
+}
+
+auto TiledImage::needs_tiling(const size_t width, const size_t height) -> bool {
+    return width > threshold || height > threshold;
+}
+
+auto TiledImage::get_coarsest() const -> gawl::PixelBuffer {
+    const auto& l = levels.back();
+    return gawl::PixelBuffer::from_raw(l.width, l.height, l.pixels);
+}
+
+auto TiledImage::get_size() const -> size_t {
+    auto total = 0uz;
+    for(const auto& l : levels) {
+        total += l.width * l.height * 4;
+    }
+    return total;
+}
+
+auto TiledImage::draw(gawl::Screen& screen, const gawl::Rectangle& area, const int (&screen_size)[2], gawl::Graphic& fallback) -> bool {
+    // coarsest level which still has at least one pixel per screen pixel
+    const auto scale = area.width() / levels[0].width;
+    auto       level = 0uz;
+    while(level + 1 < levels.size() && 1.0 / (1uz << (level + 1)) >= scale) {
+        level += 1;
+    }
+    const auto& l = levels[level];
+
+    // visible part of the image in level pixels
+    const auto view_x0 = std::max(0.0, -area.a.x) / area.width() * l.width;
+    const auto view_y0 = std::max(0.0, -area.a.y) / area.height() * l.height;
+    const auto view_x1 = std::min(area.b.x, 1. * screen_size[0]) - area.a.x;
+    const auto view_y1 = std::min(area.b.y, 1. * screen_size[1]) - area.a.y;
+    if(view_x1 <= 0 || view_y1 <= 0 || area.a.x >= screen_size[0] || area.a.y >= screen_size[1]) {
+        return true;
+    }
+    const auto columns = (l.width + tile_size - 1) / tile_size;
+    const auto rows    = (l.height + tile_size - 1) / tile_size;
+    const auto tx0     = size_t(view_x0) / tile_size;
+    const auto ty0     = size_t(view_y0) / tile_size;
+    const auto tx1     = std::min(columns, size_t(std::ceil(view_x1 / area.width() * l.width)) / tile_size + 1);
+    const auto ty1     = std::min(rows, size_t(std::ceil(view_y1 / area.height() * l.height)) / tile_size + 1);
+
+    // visible tiles first, then the margin, a few per frame so that panning does not stall on uploads
+    auto       uploads     = 0uz;
+    auto       complete    = true;
+    const auto ensure_tile = [&](const size_t tx, const size_t ty) -> gawl::Graphic* {
+        auto& tile = tiles[tile_key(level, tx, ty)];
+        if(!tile) {
+            if(uploads == max_uploads) {
+                complete = false;
+                return nullptr;
+            }
+            tile     = upload_tile(level, tx, ty);
+            uploads += 1;
+        }
+        return &tile;
+    };
+    auto visible = std::vector<gawl::Graphic*>();
+    for(auto ty = ty0; ty < ty1; ty += 1) {
+        for(auto tx = tx0; tx < tx1; tx += 1) {
+            visible.push_back(ensure_tile(tx, ty));
+        }
+    }
+    if(!complete) {
+        fallback.draw_rect(screen, area);
+    }
+
+    const auto to_screen_x = [&](const size_t x) { return area.a.x + 1. * std::min(x, l.width) / l.width * area.width(); };
+    const auto to_screen_y = [&](const size_t y) { return area.a.y + 1. * std::min(y, l.height) / l.height * area.height(); };
+    for(auto ty = ty0, i = 0uz; ty < ty1; ty += 1) {
+        for(auto tx = tx0; tx < tx1; tx += 1, i += 1) {
+            if(visible[i] == nullptr) {
+                continue;
+            }
+            const auto rect = gawl::Rectangle{{to_screen_x(tx * tile_size), to_screen_y(ty * tile_size)},
+                                              {to_screen_x((tx + 1) * tile_size), to_screen_y((ty + 1) * tile_size)}};
+            visible[i]->draw_rect(screen, rect);
+        }
+    }
+
+    // the margin
+    const auto mx0 = tx0 - std::min(tx0, margin);
+    const auto my0 = ty0 - std::min(ty0, margin);
+    const auto mx1 = std::min(columns, tx1 + margin);
+    const auto my1 = std::min(rows, ty1 + margin);
+    for(auto ty = my0; ty < my1; ty += 1) {
+        for(auto tx = mx0; tx < mx1; tx += 1) {
+            if(tx < tx0 || tx >= tx1 || ty < ty0 || ty >= ty1) {
+                ensure_tile(tx, ty);
+            }
+        }
+    }
+
+    // drop tiles outside of the margin
+    std::erase_if(tiles, [&](const auto& pair) {
+        const auto key = pair.first;
+        const auto x   = size_t(key & 0xffffff);
+        const auto y   = size_t((key >> 24) & 0xffffff);
+        if(size_t(key >> 48) != level || !pair.second) {
+            return true;
+        }
+        return x < mx0 || x >= mx1 || y < my0 || y >= my1;
+    });
+    return complete;
+}
+
+TiledImage::TiledImage(gawl::PixelBuffer source_)
+    : source(std::move(source_)) {
+    levels.push_back(Level{source.get_width(), source.get_height(), source.get_buffer(), {}});
+    while(std::max(levels.back().width, levels.back().height) > tile_size) {
+        const auto& prev   = levels.back();
+        const auto  width  = std::max(1uz, (prev.width + 1) / 2);
+        const auto  height = std::max(1uz, (prev.height + 1) / 2);
+        auto        level  = Level{width, height, nullptr, area_average(prev.pixels, prev.width, prev.height, width, height)};
+        level.pixels       = level.storage.data();
+        levels.push_back(std::move(level));
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <unordered_map>
+
+#include "../gawl/graphic.hpp"
+
+// mipmapped image split into tiles for images too large for a single texture
+// pixels stay on the cpu side, only the tiles in the viewport are uploaded
+class TiledImage {
+  private:
+    struct Level {
+        size_t                 width;
+        size_t                 height;
+        const std::byte*       pixels;
+        std::vector<std::byte> storage;
+    };
+
+    gawl::PixelBuffer                           source;
+    std::vector<Level>                          levels;
+    std::unordered_map<uint64_t, gawl::Graphic> tiles; // key: level, y, x
+
+    auto upload_tile(size_t level, size_t x, size_t y) const -> gawl::Graphic;
+
+  public:
+    constexpr static auto tile_size = 1024uz;
+
+    // whether an image of this size should be tiled
+    static auto needs_tiling(size_t width, size_t height) -> bool;
+
+    // coarsest level, fits in a tile
+    auto get_coarsest() const -> gawl::PixelBuffer;
+    auto get_size() const -> size_t;
+    // area: where the whole image is drawn
+    // fallback: drawn under tiles not uploaded yet
+    // uploads are limited per frame, returns false if tiles are still missing and another frame is needed
+    auto draw(gawl::Screen& screen, const gawl::Rectangle& area, const int (&screen_size)[2], gawl::Graphic& fallback) -> bool;
+
+    // builds the mip levels, call from a decoder thread
+    TiledImage(gawl::PixelBuffer source);
+};
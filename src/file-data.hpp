@@ -0,0 +1,10 @@
+#pragma once
+#include <memory>
+#include <span>
+
+// bytes of a page, and whatever keeps them alive: a file mapping, an archive or an inflated buffer
+struct FileData {
+    std::shared_ptr<const void> owner;
+    std::span<const std::byte>  bytes;
+    bool                        mapped = false; // bytes are a file mapping, reading them raises SIGBUS if the file is truncated meanwhile
+};
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <array>
 #include <filesystem>
 
 #include "file-list.hpp"
@@ -5,17 +7,28 @@
 #include "sort.hpp"
 
 namespace {
-template <class T, class E>
-auto contains(const T& vec, const E& elm) -> bool {
-    return std::find(vec.begin(), vec.end(), elm) != vec.end();
+auto has_image_extension(const std::string_view name) -> bool {
+    constexpr auto extensions = std::array<std::string_view, 9>{".jpg", ".jpeg", ".png", ".jxl", ".gif", ".webp", ".bmp", ".avif", ".txt"};
+    // same as std::filesystem::path::extension(), dotfiles have no extension
+    const auto pos = name.rfind('.');
+    if(pos == 0 || pos == name.npos) {
+        return false;
+    }
+    return std::ranges::find(extensions, name.substr(pos)) != extensions.end();
 }
 
-auto is_image_file(const std::filesystem::path path) -> bool {
-    constexpr auto extensions = std::array{".jpg", ".jpeg", ".png", ".jxl", ".gif", ".webp", ".bmp", ".avif", ".txt"};
-    if(!std::filesystem::is_regular_file(path)) {
-        return false;
+// directory_entry caches the file type reported by readdir, so these do not stat unless the filesystem does not report it
+auto test_filter(const std::filesystem::directory_entry& entry, const std::string_view name, const FileFilter filter) -> bool {
+    auto ec = std::error_code();
+    switch(filter) {
+    case FileFilter::None:
+        return true;
+    case FileFilter::Works:
+        return entry.is_directory(ec) || (Archive::is_archive(name) && entry.is_regular_file(ec));
+    case FileFilter::Images:
+        return has_image_extension(name) && entry.is_regular_file(ec);
     }
-    return contains(extensions, path.extension().string());
+    return false;
 }
 } // namespace
 
@@ -23,11 +36,30 @@ auto get_parent_dir(std::string_view dir) -> std::string {
     return std::filesystem::path(dir).parent_path().string();
 }
 
-auto list_files(const std::string_view path) -> std::optional<FileList> {
+auto list_files(const std::string_view path, const FileFilter filter) -> std::optional<FileList> {
     auto fl = FileList{std::string(path), {}, 0};
+    if(Archive::is_archive(path) && !std::filesystem::is_directory(path)) {
+        if(filter == FileFilter::Works) {
+            // archives do not nest
+            return fl;
+        }
+        auto archive = Archive::open(fl.prefix);
+        ensure(archive);
+        for(const auto& name : archive->get_names()) {
+            if(filter == FileFilter::None || has_image_extension(name)) {
+                fl.files.push_back(name);
+            }
+        }
+        fl.archive = std::move(archive);
+        sort_strings(fl.files);
+        return fl;
+    }
     try {
         for(const auto& it : std::filesystem::directory_iterator(path)) {
-            fl.files.push_back(it.path().filename().string());
+            auto name = it.path().filename().string();
+            if(test_filter(it, name, filter)) {
+                fl.files.push_back(std::move(name));
+            }
         }
     } catch(std::filesystem::filesystem_error& e) {
         bail("filesystem error: {}", e.what());
@@ -36,16 +68,26 @@ auto list_files(const std::string_view path) -> std::optional<FileList> {
     return fl;
 }
 
-auto filter_non_image_files(FileList& list) -> void {
-    std::erase_if(list.files, [&list](const std::string& path) {
-        return !is_image_file(list.prefix / path);
-    });
-    return;
+auto insert_file(FileList& list, const std::string_view name, const FileFilter filter) -> std::optional<size_t> {
+    auto ec = std::error_code();
+    ensure(test_filter(std::filesystem::directory_entry(list.prefix / name, ec), name, filter));
+    const auto it = std::ranges::lower_bound(list.files, name, compare_strings);
+    ensure(it == list.files.end() || *it != name);
+    const auto pos = size_t(it - list.files.begin());
+    if(!list.files.empty() && pos <= list.index) {
+        list.index += 1;
+    }
+    list.files.insert(pos, name);
+    return pos;
 }
 
-auto filter_regular_files(FileList& list) -> void {
-    std::erase_if(list.files, [&list](const std::string& path) {
-        return std::filesystem::is_regular_file(list.prefix / path);
-    });
-    return;
+auto remove_file(FileList& list, const std::string_view name) -> std::optional<size_t> {
+    const auto it = std::ranges::lower_bound(list.files, name, compare_strings);
+    ensure(it != list.files.end() && *it == name);
+    const auto pos = size_t(it - list.files.begin());
+    list.files.erase(pos);
+    if(pos < list.index || (list.index > 0 && list.index == list.files.size())) {
+        list.index -= 1;
+    }
+    return pos;
 }
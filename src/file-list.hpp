@@ -3,15 +3,28 @@
 #include <optional>
 #include <string>
 #include <string_view>
-#include <vector>
+
+#include "archive.hpp"
+#include "name-list.hpp"
+
+enum class FileFilter {
+    None,
+    Works, // directories and archives
+    Images,
+};
 
 struct FileList {
-    std::filesystem::path    prefix;
-    std::vector<std::string> files;
-    size_t                   index;
+    std::filesystem::path          prefix;
+    NameList                       files;
+    size_t                         index;
+    std::shared_ptr<const Archive> archive = {}; // set if prefix is an archive, files are then member names
 };
 
 auto get_parent_dir(std::string_view dir) -> std::string;
-auto list_files(std::string_view dir) -> std::optional<FileList>;
-auto filter_non_image_files(FileList& list) -> void;
-auto filter_regular_files(FileList& list) -> void;
+// dir may also be an archive
+auto list_files(std::string_view dir, FileFilter filter = FileFilter::None) -> std::optional<FileList>;
+// keep a directory listing in sync without listing it again, index keeps pointing at the same file
+// returns the position of the inserted file, nullopt if it is filtered out or already listed
+auto insert_file(FileList& list, std::string_view name, FileFilter filter) -> std::optional<size_t>;
+// returns the position the file was at, if the current file is removed index moves to the next one
+auto remove_file(FileList& list, std::string_view name) -> std::optional<size_t>;
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <filesystem>
 
-#include <coop/parallel.hpp>
+#include <coop/io.hpp>
 #include <coop/task-handle.hpp>
 #include <coop/thread.hpp>
+#include <coop/timer.hpp>
 #include <linux/input.h>
 
 #include "displayable/image.hpp"
@@ -14,49 +16,50 @@
 #include "gawl/wayland/window.hpp"
 #include "imgview.hpp"
 #include "macros/unwrap.hpp"
+#include "sort.hpp"
 #include "util/charconv.hpp"
 
 namespace {
-auto find_current_index(const std::filesystem::path dir) -> std::optional<FileList> {
-    unwrap_mut(list, list_files(dir.parent_path().string()));
-    filter_regular_files(list);
-    for(auto i = 0uz; i < list.files.size(); i += 1) {
-        if(list.files[i] == dir.filename().string()) {
-            list.index = i;
-            return list;
+struct Position {
+    std::shared_ptr<const FileList> list;
+    size_t                          index;
+};
+
+auto find_current_index(DirIndex& dirs, const std::filesystem::path dir) -> std::optional<Position> {
+    auto list = dirs.get(dir.parent_path().string(), FileFilter::Works);
+    ensure(list);
+    for(auto i = 0uz; i < list->files.size(); i += 1) {
+        if(list->files[i] == dir.filename().string()) {
+            return Position{std::move(list), i};
         }
     }
     return std::nullopt;
 }
 
-auto find_deepest_dir(const std::filesystem::path dir) -> std::optional<std::string> {
-    unwrap_mut(list, list_files(dir.string()));
-    filter_regular_files(list);
-    for(const auto& file : list.files) {
-        const auto path = list.prefix / file;
-        if(std::filesystem::is_directory(path)) {
-            return find_deepest_dir(path);
-        }
+auto find_deepest_dir(DirIndex& dirs, const std::filesystem::path dir) -> std::optional<std::string> {
+    unwrap(list, dirs.get(dir.string(), FileFilter::Works));
+    if(!list.files.empty()) {
+        return find_deepest_dir(dirs, list.prefix / list.files[0]);
     }
     return dir.string();
 }
 
-auto find_next_directory(const std::filesystem::path dir, const bool reverse) -> std::optional<std::string> {
-    unwrap(list, find_current_index(dir));
-    if((reverse && list.index == 0) || (!reverse && list.index + 1 >= list.files.size())) {
+auto find_next_directory(DirIndex& dirs, const std::filesystem::path dir, const bool reverse) -> std::optional<std::string> {
+    unwrap(pos, find_current_index(dirs, dir));
+    const auto& list = *pos.list;
+    if((reverse && pos.index == 0) || (!reverse && pos.index + 1 >= list.files.size())) {
         if(dir.parent_path() == dir) { // dir == "/"
             return std::nullopt;
         }
-        return find_next_directory(dir.parent_path(), reverse);
+        return find_next_directory(dirs, dir.parent_path(), reverse);
     }
-    return find_deepest_dir(list.prefix / list.files[list.index + (reverse ? -1 : 1)]);
+    return find_deepest_dir(dirs, list.prefix / list.files[pos.index + (reverse ? -1 : 1)]);
 }
 
-auto find_next_displayable_directory(std::filesystem::path dir, const bool reverse) -> std::optional<FileList> {
+auto find_next_displayable_directory(DirIndex& dirs, std::filesystem::path dir, const bool reverse) -> std::optional<FileList> {
 loop:
-    unwrap_mut(next_dir, find_next_directory(dir, reverse));
-    unwrap_mut(list, list_files(next_dir));
-    filter_non_image_files(list);
+    unwrap_mut(next_dir, find_next_directory(dirs, dir, reverse));
+    unwrap(list, dirs.get(next_dir, FileFilter::Images));
     if(!list.files.empty()) {
         return list;
     }
@@ -65,18 +68,40 @@ loop:
 }
 } // namespace
 
+// pages shown at once from list.index, two in spread mode unless at the last page
+auto Callbacks::view_pages() const -> size_t {
+    const auto pages = config.spread != Spread::Off ? 2uz : 1uz;
+    return std::min(pages, list.files.size() - list.index);
+}
+
 auto Callbacks::change_page(const bool reverse) -> void {
     {
-        if((reverse && list.index == 0) || (!reverse && list.index + 1 == list.files.size())) {
+        const auto step = config.spread != Spread::Off ? 2uz : 1uz;
+        if(listing || (reverse && list.index == 0) || (!reverse && list.index + step >= list.files.size())) {
             return;
         }
-        list.index += reverse ? -1 : 1;
+        list.index = reverse ? list.index - std::min(step, list.index) : list.index + step;
     }
-    worker_event.notify();
-    window->refresh();
+    paging_reverse = reverse;
+    pipeline.notify();
+    request_readahead();
+    request_redraw();
+}
+
+// files past the pages the memory budget covers, in the paging direction
+auto Callbacks::request_readahead() -> void {
+    if(!readahead || list.archive) {
+        return;
+    }
+    auto paths = std::vector<std::string>();
+    for(const auto i : cache.beyond_budget(list.index, paging_reverse, config.readahead, list.files.size(), keep_range, config.cache_budget)) {
+        paths.push_back((list.prefix / list.files[i]).string());
+    }
+    readahead->request(std::move(paths));
 }
 
 auto Callbacks::set_index_by_page_jump_buffer() -> bool {
+    ensure(!listing);
     unwrap(page, from_chars<size_t>(page_jump_buffer));
     ensure(page < list.files.size());
     list.index = page;
@@ -89,80 +114,350 @@ auto Callbacks::reset_draw_pos() -> void {
     draw_scale     = 0.0;
 }
 
-auto Callbacks::worker_main() -> coop::Async<void> {
+auto Callbacks::create_displayable(const std::string_view file, const bool full_resolution) -> std::shared_ptr<Displayable> {
+    const auto ext = std::filesystem::path(file).extension();
+    auto       ptr = (Displayable*)(nullptr);
+    if(ext == ".txt") {
+        ptr = new DisplayableText(font);
+    } else if(config.decode_to_screen && !full_resolution) {
+        const auto [width, height] = window->get_window_size();
+        ptr                        = new DisplayableImage({size_t(width), size_t(height)});
+    } else {
+        ptr = new DisplayableImage();
+    }
+    return std::shared_ptr<Displayable>(ptr);
+}
+
+auto Callbacks::find_cache(const std::filesystem::path& work, const size_t index, const std::string_view file) -> PageCache* {
+    if(list.prefix == work) {
+        if(index < list.files.size() && list.files[index] == file) {
+            return &cache;
+        }
+        return nullptr;
+    }
+    for(auto& neighbor : neighbors) {
+        if(neighbor.list && neighbor.list->prefix == work && index < neighbor.list->files.size() && neighbor.list->files[index] == file) {
+            return &neighbor.cache;
+        }
+    }
+    return nullptr;
+}
+
+auto Callbacks::switch_work(FileList next, PageCache next_cache, const bool reverse) -> void {
+    // the leaving work is likely to be the neighbor in the opposite direction, keep its first pages
+    cache.truncate(prefetch_pages);
+    list.index = 0;
+
+    neighbors[reverse ? 0 : 1] = Neighbor{{}, std::move(list), std::move(cache)};
+    neighbors[reverse ? 1 : 0] = Neighbor();
+
+    list  = std::move(next);
+    cache = std::move(next_cache);
+    live  = true;
+    watch_work();
+    work_event.notify();
+    pipeline.notify();
+    request_readahead();
+    request_redraw();
+}
+
+auto Callbacks::resolver_main() -> coop::Async<void> {
 loop:
-    // find target
-    auto displayable = std::shared_ptr<Displayable>();
-    auto work        = std::filesystem::path();
-    auto file        = std::string();
-    auto index       = int();
-
-    const auto range = std::min(cache_range, int(list.files.size() / 2) + 1);
-    for(auto distance = 0; distance < range; distance += 1) {
-        for(auto backward = (distance == 0 ? 1 : 0); backward < 2; backward += 1) {
-            const auto i = int(list.index) + (backward == 0 ? distance : -distance);
-            if(i < 0 || size_t(i) >= list.files.size()) {
-                continue;
-            }
-            if(cache[i]) {
-                continue;
-            }
-            const auto ext = std::filesystem::path(list.files[i]).extension();
-            auto       ptr = (Displayable*)(nullptr);
-            if(ext == ".txt") {
-                ptr = new DisplayableText(font);
-            } else {
-                ptr = new DisplayableImage();
-            }
-            displayable = std::shared_ptr<Displayable>(ptr);
-            cache[i]    = displayable;
-            work        = list.prefix;
-            file        = list.files[i];
-            index       = i;
-            goto search_end;
+    for(auto i = 0; i < 2; i += 1) {
+        auto& neighbor = neighbors[i];
+        if(neighbor.origin == list.prefix) {
+            continue;
+        }
+
+        const auto origin = list.prefix;
+        auto       next   = co_await coop::run_blocking([this, &origin, i]() {
+            return find_next_displayable_directory(dir_index, origin, i == 1);
+        });
+        if(list.prefix != origin) {
+            // work changed while resolving
+            goto loop;
         }
+
+        neighbor.origin = origin;
+        if(!next) {
+            neighbor.list.reset();
+            neighbor.cache = PageCache();
+            continue;
+        }
+        // keep already prefetched pages if the neighbor is unchanged
+        const auto count = std::min(prefetch_pages, next->files.size());
+        const auto keep  = neighbor.list && neighbor.list->prefix == next->prefix &&
+                           neighbor.list->files.size() >= count &&
+                           std::equal(next->files.begin(), next->files.begin() + count, neighbor.list->files.begin());
+        if(!keep) {
+            neighbor.cache = PageCache();
+        }
+        neighbor.list = std::move(next);
+        pipeline.notify();
     }
-search_end:
-    if(!displayable) {
-        co_await worker_event;
+    co_await work_event;
+    goto loop;
+}
+
+auto Callbacks::player_main() -> coop::Async<void> {
+loop:
+    const auto dable     = last_displayed;
+    const auto animation = dable ? dable->get_animation() : nullptr;
+    if(animation == nullptr || dable->state != Displayable::State::Loaded) {
+        co_await displayed_event;
         goto loop;
     }
+    if(!co_await coop::run_blocking([animation]() { return animation->fill(); })) {
+        // broken frame, stop at the last good one
+        co_await displayed_event;
+        goto loop;
+    }
+    if(const auto wait = animation->get_deadline() - Animation::Clock::now(); wait.count() > 0) {
+        co_await coop::sleep(wait);
+    }
+    if(last_displayed == dable && animation->advance(Animation::Clock::now())) {
+        request_redraw();
+    }
+    goto loop;
+}
 
-    // load file
-    const auto path = work / file;
-    if(!co_await coop::run_blocking([&]() {
-           auto context = std::bit_cast<gawl::WaylandWindow*>(window)->fork_context();
-           if(!displayable->load(path.string())) {
-               return false;
-           }
-           context.wait();
-           return true;
-       })) {
-        displayable = std::shared_ptr<Displayable>(new DisplayableText(font, "broken image"));
+auto Callbacks::watch_work() -> void {
+    if(!dir_watcher) {
+        return;
+    }
+    if(!live || list.archive || !dir_watcher->set_dir(list.prefix)) {
+        dir_watcher->unset_dir();
+        return;
+    }
+    // the list may be older than the watch, a neighbor is listed when it is resolved
+    resync_pending = true;
+    resync_event.notify();
+}
+
+auto Callbacks::apply_dir_event(const DirWatcher::Event& event) -> bool {
+    if(const auto it = std::ranges::lower_bound(list.files, event.name, compare_strings); event.added && it != list.files.end() && *it == event.name) {
+        // rewritten in place, e.g. by a downloader, the decoded page is stale
+        const auto pos = size_t(it - list.files.begin());
+        cache.erase(pos);
+        grid.reload_slot(list, pos);
+        return true;
+    }
+    if(event.added) {
+        unwrap(pos, insert_file(list, event.name, FileFilter::Images));
+        cache.insert_slot(pos);
+        grid.insert_slot(list, pos);
+    } else {
+        unwrap(pos, remove_file(list, event.name));
+        cache.remove_slot(pos);
+        grid.remove_slot(list, pos);
     }
+    return true;
+}
+
+auto Callbacks::apply_dir_events(const std::vector<DirWatcher::Event>& events) -> void {
+    auto changed = false;
+    for(const auto& event : events) {
+        changed |= apply_dir_event(event);
+    }
+    if(changed) {
+        pipeline.notify();
+        request_redraw();
+    }
+}
+
+// events turning list into a fresh listing of its directory, for when the watcher lost events
+auto Callbacks::diff_listing() -> coop::Async<std::vector<DirWatcher::Event>> {
+    const auto dir  = list.prefix;
+    const auto full = co_await coop::run_blocking([this, &dir]() {
+        return dir_index.get(dir.string(), FileFilter::Images);
+    });
+    auto events = std::vector<DirWatcher::Event>();
+    if(!full || list.prefix != dir) {
+        co_return events;
+    }
+    // both are sorted, walk them together
+    const auto& now = full->files;
+    for(auto i = 0uz, j = 0uz; i < list.files.size() || j < now.size();) {
+        if(i < list.files.size() && j < now.size() && list.files[i] == now[j]) {
+            i += 1;
+            j += 1;
+        } else if(j == now.size() || (i < list.files.size() && compare_strings(list.files[i], now[j]))) {
+            events.push_back({std::string(list.files[i]), false});
+            i += 1;
+        } else {
+            events.push_back({std::string(now[j]), true});
+            j += 1;
+        }
+    }
+    co_return events;
+}
+
+auto Callbacks::watcher_main() -> coop::Async<void> {
+loop:
+    co_await coop::wait_for_file(dir_watcher->get_fd(), true, false);
+    if(const auto events = dir_watcher->read()) {
+        apply_dir_events(*events);
+    } else {
+        // queue overflow
+        resync_pending = true;
+        resync_event.notify();
+    }
+    goto loop;
+}
 
-    // store
-    if(list.prefix != work) {
-        // work changed
+auto Callbacks::resyncer_main() -> coop::Async<void> {
+loop:
+    if(!resync_pending) {
+        co_await resync_event;
         goto loop;
     }
+    resync_pending = false;
+    apply_dir_events(co_await diff_listing());
+    goto loop;
+}
 
-    displayable->loaded = true;
-    cache[index]        = std::move(displayable);
-    window->refresh();
+auto Callbacks::lister_main() -> coop::Async<void> {
+    const auto dir  = list.prefix;
+    const auto file = std::string(list.files[0]);
+    const auto full = co_await coop::run_blocking([this, &dir]() {
+        return dir_index.get(dir.string(), FileFilter::Images);
+    });
+    // keep the page being loaded, its job refers to index 0 of the single file list
+    // a preview is not enough, the full decode still in flight would be dropped once the page moves
+    while(cache.contains(0) && cache.peek(0)->state != Displayable::State::Loaded) {
+        co_await loaded_event;
+    }
 
-    // clean cache
-    const auto begin = list.index > cache_range ? list.index - cache_range : 0;
-    const auto end   = std::min(list.index + cache_range, list.files.size() - 1);
+    listing = false;
+    live    = true;
+    if(full && !full->files.empty()) {
+        const auto page = cache.get(0);
+        const auto it   = std::ranges::lower_bound(full->files, file, compare_strings);
+        const auto pos  = size_t(it - full->files.begin());
+        list            = *full;
+        list.index      = 0;
+        cache           = PageCache();
+        if(pos < list.files.size() && list.files[pos] == file) {
+            list.index = pos;
+            if(page) {
+                cache.set(pos, page);
+            }
+        }
+    }
+    watch_work();
+    pipeline.notify();
+    request_redraw();
+}
 
-    for(auto i = 0uz; i < begin; i += 1) {
-        cache[i].reset();
+auto Callbacks::schedule() -> std::shared_ptr<Job> {
+    // full resolution of the pages on screen while zoomed, one at a time
+    for(auto i = list.index; draw_scale != 0 && !upgrading && i < list.index + view_pages(); i += 1) {
+        const auto current = cache.peek(i);
+        if(current != nullptr && current->state == Displayable::State::Loaded && current->reduced) {
+            upgrading = true;
+            return std::shared_ptr<Job>(new Job{.work = list.prefix, .index = i, .file = std::string(list.files[i]), .archive = list.archive, .displayable = create_displayable(list.files[i], true), .replaces = current});
+        }
     }
-    for(auto i = end + 1; i < cache.size(); i += 1) {
-        cache[i].reset();
+
+    const auto claim = [this](const FileList& target, PageCache& slots, const size_t i) {
+        auto displayable = create_displayable(target.files[i], false);
+        slots.set(i, displayable);
+        return std::shared_ptr<Job>(new Job{.work = target.prefix, .index = i, .file = std::string(target.files[i]), .archive = target.archive, .displayable = std::move(displayable)});
+    };
+
+    // pages around the current one, as many as the memory budget allows
+    if(const auto i = cache.next_claim(list.index, view_pages(), list.files.size(), keep_range, config.cache_budget)) {
+        return claim(list, cache, *i);
     }
 
-    goto loop;
+    // first pages of the neighbor works
+    for(auto& neighbor : neighbors) {
+        if(!neighbor.list) {
+            continue;
+        }
+        for(auto i = 0uz; i < std::min(prefetch_pages, neighbor.list->files.size()); i += 1) {
+            if(neighbor.cache.contains(i)) {
+                continue;
+            }
+            return claim(*neighbor.list, neighbor.cache, i);
+        }
+    }
+    return nullptr;
+}
+
+auto Callbacks::prioritize(const Job& job) -> std::optional<size_t> {
+    const auto target = find_cache(job.work, job.index, job.file);
+    if(target == nullptr || target->peek(job.index) != (job.replaces != nullptr ? job.replaces : job.displayable.get())) {
+        // work changed or the page was dropped
+        return std::nullopt;
+    }
+    if(job.replaces != nullptr) {
+        // upgrades are only for the pages on screen
+        return job.index >= list.index && job.index < list.index + view_pages() && target == &cache ? std::optional(0uz) : std::nullopt;
+    }
+    if(target != &cache) {
+        // neighbor works come after every page of the current work
+        return list.files.size() + job.index;
+    }
+    return cache.priority(job.index, list.index, view_pages(), list.files.size(), keep_range, config.cache_budget);
+}
+
+auto Callbacks::finish(const std::shared_ptr<Job> job) -> void {
+    if(job->replaces != nullptr) {
+        upgrading = false;
+    }
+    const auto target = find_cache(job->work, job->index, job->file);
+    if(target == nullptr || target->peek(job->index) != (job->replaces != nullptr ? job->replaces : job->displayable.get())) {
+        // work changed or the page was dropped while loading
+        return;
+    }
+    if(job->replaces != nullptr && !job->ok) {
+        // keep the reduced page, and do not retry unless the upgrade was only cancelled
+        if(!job->cancelled) {
+            job->replaces->reduced = false;
+        }
+        return;
+    }
+    if(job->cancelled) {
+        // release the claim so that the page can be scheduled again
+        target->erase(job->index);
+        return;
+    }
+    if(job->preview) {
+        if(job->ok && job->displayable->state == Displayable::State::Loading) {
+            job->displayable->state = Displayable::State::Preview;
+            if(target == &cache) {
+                request_redraw();
+            }
+        }
+        return;
+    }
+
+    if(trace) {
+        trace->add_page(job->timing, (job->work / job->file).string());
+    }
+    auto displayable = std::move(job->displayable);
+    if(!job->ok) {
+        displayable = std::shared_ptr<Displayable>(new DisplayableText(font, "broken image"));
+    }
+    displayable->state  = Displayable::State::Loaded;
+    displayable->timing = job->timing;
+    target->set(job->index, std::move(displayable));
+    if(target != &cache) {
+        return;
+    }
+    loaded_event.notify();
+    request_redraw();
+    cache.evict(list.index, keep_range, config.cache_budget);
+}
+
+auto Callbacks::quit() -> void {
+    // the destructor does not run after quick_exit
+    if(trace) {
+        trace->save(config.trace);
+    }
+    std::quick_exit(0); // hack
+    application->quit();
 }
 
 auto Callbacks::close() -> void {
@@ -170,128 +465,308 @@ auto Callbacks::close() -> void {
 }
 
 auto Callbacks::refresh() -> void {
+    const auto begin = TraceClock::now();
+    refresh_page();
+    if(trace) {
+        trace->add("refresh", Trace::Lane::Render, begin, TraceClock::now());
+    }
+}
+
+// input only marks the frame dirty, bursts of events are drawn together at most once per frame_interval
+auto Callbacks::request_redraw() -> void {
+    redraw_pending = true;
+    redraw_event.notify();
+}
+
+auto Callbacks::redrawer_main() -> coop::Async<void> {
+loop:
+    if(!redraw_pending) {
+        co_await redraw_event;
+        goto loop;
+    }
+    redraw_pending   = false;
+    const auto begin = std::chrono::steady_clock::now();
+    window->refresh();
+    if(const auto wait = frame_interval - (std::chrono::steady_clock::now() - begin); wait.count() > 0) {
+        co_await coop::sleep(wait);
+    }
+    goto loop;
+}
+
+auto Callbacks::set_overlay(Overlay& overlay, std::string text) -> void {
+    overlay.text = std::move(text);
+    overlay.rect = font.get_rect(*window, overlay.text);
+}
+
+auto Callbacks::update_info_overlay(const size_t pages) -> void {
+    const auto  timed     = show_timings ? last_displayed.get() : nullptr;
+    const auto  timed_end = timed != nullptr ? timed->timing.upload_end : TraceClock::time_point();
+    const auto  file      = list.files[list.index];
+    if(const auto& src = info_source; src && src->index == list.index && src->total == list.files.size() && src->pages == pages &&
+                                      src->listing == listing && src->timed == timed && src->timed_end == timed_end && src->file == file && src->prefix == list.prefix) {
+        return;
+    }
+    info_source = InfoSource{list.prefix, std::string(file), list.index, list.files.size(), pages, listing, timed, timed_end};
+
+    const auto path  = list.prefix / file;
+    const auto info  = path.parent_path().filename() / path.filename();
+    const auto total = listing ? std::string("?") : std::to_string(list.files.size());
+    auto       str   = pages == 2 ? std::format("[{}-{}/{}]{}", list.index + 1, list.index + 2, total, info.string())
+                                  : std::format("[{}/{}]{}", list.index + 1, total, info.string());
+    if(timed != nullptr) {
+        str += "  " + format_timing(timed->timing);
+    }
+    set_overlay(info_overlay, std::move(str));
+}
+
+auto Callbacks::draw_pages(const std::shared_ptr<Displayable>& first, const std::shared_ptr<Displayable>& second, DrawParameters params) -> void {
+    if(!second) {
+        first->draw(window, params);
+    } else {
+        const auto rtl = config.spread == Spread::RightToLeft;
+        params.side    = rtl ? DrawParameters::Side::Right : DrawParameters::Side::Left;
+        first->draw(window, params);
+        params.side = rtl ? DrawParameters::Side::Left : DrawParameters::Side::Right;
+        second->draw(window, params);
+    }
+    // e.g. tiles of a large image are uploaded over several frames
+    if(first->needs_redraw() || (second && second->needs_redraw())) {
+        request_redraw();
+    }
+}
+
+auto Callbacks::refresh_page() -> void {
     gawl::clear_screen({0, 0, 0, fill_background ? 1.0 : 0.0});
     const auto [width, height] = window->get_window_size();
     if(list.files.empty()) {
         return;
     }
+    if(grid_mode) {
+        grid.draw(*window, {width, height});
+        return;
+    }
 
     const auto draw_params = DrawParameters{{width, height}, {draw_offset[0], draw_offset[1]}, draw_scale};
-    const auto path        = list.prefix / list.files[list.index];
+    const auto pages       = view_pages();
     {
-        const auto dable = cache[list.index];
-        if(dable && dable->loaded) {
-            dable->draw(window, draw_params);
-            last_displayed = dable;
+        const auto ready  = [](const std::shared_ptr<Displayable>& dable) { return dable && dable->state != Displayable::State::Loading; };
+        const auto dable  = cache.get(list.index);
+        const auto facing = pages == 2 ? cache.get(list.index + 1) : nullptr;
+        // a spread is drawn only when both of its pages are
+        if(ready(dable) && (pages == 1 || ready(facing))) {
+            draw_pages(dable, facing, draw_params);
+            last_facing = facing;
+            if(last_displayed != dable) {
+                last_displayed = dable;
+                displayed_event.notify();
+            }
         } else {
             if(last_displayed) {
-                last_displayed->draw(window, draw_params);
+                draw_pages(last_displayed, last_facing, draw_params);
             }
             font.draw_fit_rect(*window, {{0, 0}, {1. * width, 1. * height}}, {1, 1, 1, 1}, "loading...");
         }
     }
     auto top = 0.0;
     if(!hide_info) {
-        const auto info = path.parent_path().filename() / path.filename();
-        const auto str  = std::format("[{}/{}]{}", list.index + 1, list.files.size(), info.string());
-        const auto rect = gawl::Rectangle(font.get_rect(*window, str)).expand(2, 2);
+        update_info_overlay(pages);
+        const auto rect = gawl::Rectangle(info_overlay.rect).expand(2, 2);
         const auto box  = gawl::Rectangle{{0, height - rect.height() - top}, {rect.width(), height - top}};
         gawl::draw_rect(*window, box, {0, 0, 0, 0.5});
-        font.draw_fit_rect(*window, box, {1, 1, 1, 0.7}, str);
+        font.draw_fit_rect(*window, box, {1, 1, 1, 0.7}, info_overlay.text);
         top += rect.height();
     }
     if(page_jump) {
-        const auto str  = std::format("Page: {}", page_jump_buffer);
-        const auto rect = font.get_rect(*window, str);
-        const auto box  = gawl::Rectangle{{0, height - rect.height() - top}, {rect.width(), height - top}};
-        font.draw_fit_rect(*window, box, {1, 1, 1, 0.7}, str);
+        if(jump_source != page_jump_buffer) {
+            jump_source = page_jump_buffer;
+            set_overlay(jump_overlay, std::format("Page: {}", page_jump_buffer));
+        }
+        const auto& rect = jump_overlay.rect;
+        const auto  box  = gawl::Rectangle{{0, height - rect.height() - top}, {rect.width(), height - top}};
+        font.draw_fit_rect(*window, box, {1, 1, 1, 0.7}, jump_overlay.text);
         top += rect.height();
     }
 }
 
+auto Callbacks::open_grid() -> void {
+    if(listing || list.files.empty()) {
+        return;
+    }
+    grid_mode = true;
+    page_jump = false;
+    grid.open(list, list.index);
+    request_redraw();
+}
+
+auto Callbacks::close_grid(const bool apply) -> void {
+    grid_mode = false;
+    grid.close();
+    if(apply && grid.get_selected() != list.index) {
+        paging_reverse = grid.get_selected() < list.index;
+        list.index     = grid.get_selected();
+        reset_draw_pos();
+        pipeline.notify();
+        request_readahead();
+    }
+    request_redraw();
+}
+
+auto Callbacks::on_grid_keycode(const uint32_t keycode) -> void {
+    switch(keycode) {
+    case KEY_Q:
+    case KEY_BACKSLASH:
+        quit();
+        break;
+    case KEY_G:
+    case KEY_ESC:
+        close_grid(false);
+        return;
+    case KEY_ENTER:
+        close_grid(true);
+        return;
+    case KEY_LEFT:
+    case KEY_H:
+        grid.move_selection(-1, 0);
+        break;
+    case KEY_RIGHT:
+    case KEY_L:
+        grid.move_selection(1, 0);
+        break;
+    case KEY_UP:
+    case KEY_K:
+        grid.move_selection(0, -1);
+        break;
+    case KEY_DOWN:
+    case KEY_J:
+        grid.move_selection(0, 1);
+        break;
+    }
+    request_redraw();
+}
+
 auto Callbacks::on_keycode(const uint32_t keycode, const gawl::ButtonState state) -> coop::Async<bool> {
     constexpr auto error_value = true;
 
     if(state == gawl::ButtonState::Enter || state == gawl::ButtonState::Leave || state == gawl::ButtonState::Release) {
         co_return true;
     }
+    if(grid_mode) {
+        on_grid_keycode(keycode);
+        co_return true;
+    }
 
     switch(keycode) {
     case KEY_Q:
     case KEY_BACKSLASH:
-        // quit
-        std::quick_exit(0); // hack
-        application->quit();
+        quit();
         break;
     case KEY_DOWN:
     case KEY_UP: {
         // next/prev work
         const auto reverse = keycode == KEY_UP;
-        {
-            co_unwrap_v_mut(next_list, find_next_displayable_directory(list.prefix, reverse), "cannot find next directory");
-            list  = std::move(next_list);
-            cache = Cache(list.files.size());
+        if(switching_work || listing) {
+            break;
+        }
+        auto& neighbor = neighbors[reverse ? 1 : 0];
+        if(neighbor.origin == list.prefix) {
+            // already resolved by the prefetcher
+            co_unwrap_v_mut(next_list, neighbor.list, "cannot find next directory");
+            switch_work(std::move(next_list), std::move(neighbor.cache), reverse);
+            break;
         }
-        worker_event.notify();
-        window->refresh();
+
+        const auto origin = list.prefix;
+        switching_work    = true;
+        auto next         = co_await coop::run_blocking([this, &origin, reverse]() {
+            return find_next_displayable_directory(dir_index, origin, reverse);
+        });
+        switching_work    = false;
+        if(list.prefix != origin) {
+            break;
+        }
+        co_unwrap_v_mut(next_list, next, "cannot find next directory");
+        switch_work(std::move(next_list), {}, reverse);
     } break;
     case KEY_SPACE:
     case KEY_RIGHT:
     case KEY_LEFT: {
-        // next/prev page
-        const auto reverse = keycode == KEY_LEFT;
+        // next/prev page, the arrows follow the reading direction
+        const auto rtl     = config.spread == Spread::RightToLeft && keycode != KEY_SPACE;
+        const auto reverse = (keycode == KEY_LEFT) != rtl;
         change_page(reverse);
     } break;
     case KEY_P:
         // page jump begin
         page_jump = true;
         page_jump_buffer.clear();
-        window->refresh();
+        request_redraw();
         break;
     case KEY_ESC:
         // page jump cancel
         page_jump = false;
-        window->refresh();
+        request_redraw();
         break;
     case KEY_BACKSPACE:
         // page jump delete
         if(!page_jump_buffer.empty()) {
             page_jump_buffer.pop_back();
         }
-        window->refresh();
+        request_redraw();
         break;
     case KEY_ENTER:
         // page jump apply
         if(set_index_by_page_jump_buffer()) {
-            worker_event.notify();
+            pipeline.notify();
         }
         page_jump = false;
-        window->refresh();
+        request_redraw();
         break;
     case KEY_H:
     case KEY_L:
         // move horizontal position
         draw_offset[0] += keycode == KEY_H ? move_speed : -move_speed;
-        window->refresh();
+        request_redraw();
         break;
     case KEY_K:
     case KEY_J:
         // move vertical position
         draw_offset[1] += keycode == KEY_K ? move_speed : -move_speed;
-        window->refresh();
+        request_redraw();
         break;
     case KEY_O:
         // reset position
         reset_draw_pos();
-        window->refresh();
+        request_redraw();
         break;
     case KEY_I:
         hide_info = !hide_info;
-        window->refresh();
+        request_redraw();
         break;
     case KEY_B:
         fill_background = !fill_background;
-        window->refresh();
+        request_redraw();
+        break;
+    case KEY_D:
+        // spread mode off -> left to right -> right to left
+        config.spread = config.spread == Spread::Off           ? Spread::LeftToRight
+                        : config.spread == Spread::LeftToRight ? Spread::RightToLeft
+                                                               : Spread::Off;
+        pipeline.notify();
+        request_redraw();
+        break;
+    case KEY_G:
+        // thumbnail grid
+        open_grid();
+        break;
+    case KEY_T:
+        show_timings = !show_timings;
+        request_redraw();
+        break;
+    case KEY_E:
+        // export trace
+        if(trace) {
+            trace->save(config.trace);
+        }
         break;
     }
 
@@ -299,7 +774,7 @@ auto Callbacks::on_keycode(const uint32_t keycode, const gawl::ButtonState state
         if(keycode >= KEY_1 && keycode <= KEY_0) {
             // page jump input
             page_jump_buffer += (keycode == KEY_0 ? '0' : char('1' + keycode - KEY_1));
-            window->refresh();
+            request_redraw();
         }
     }
     co_return true;
@@ -307,7 +782,12 @@ auto Callbacks::on_keycode(const uint32_t keycode, const gawl::ButtonState state
 
 auto Callbacks::on_pointer(const gawl::Point pos) -> coop::Async<bool> {
     auto do_refresh = false;
-    if(pointer_pos.has_value()) {
+    if(pointer_pos.has_value() && grid_mode) {
+        if(clicked[0]) {
+            grid.scroll_by(pointer_pos->y - pos.y);
+            do_refresh = true;
+        }
+    } else if(pointer_pos.has_value()) {
         if(clicked[0]) {
             draw_offset[0] += pos.x - pointer_pos->x;
             draw_offset[1] += pos.y - pointer_pos->y;
@@ -315,25 +795,37 @@ auto Callbacks::on_pointer(const gawl::Point pos) -> coop::Async<bool> {
         }
         if(clicked[1]) {
             do {
-                const auto path = (list.prefix / list.files[list.index]).string();
-                if(!cache[list.index] || !cache[list.index]->loaded) {
-                    break;
-                }
                 const auto [width, height] = window->get_window_size();
                 const auto value           = (pos.y - pointer_pos->y) * 0.01;
                 auto       draw_params     = DrawParameters{{width, height}, {draw_offset[0], draw_offset[1]}, draw_scale};
-                cache[list.index]->zoom_by_drag(window, clicked_pos[1], value, draw_params);
+                const auto dable           = cache.get(list.index);
+                const auto facing          = view_pages() == 2 ? cache.get(list.index + 1) : nullptr;
+                auto       anchor          = dable;
+                if(facing) {
+                    // zoom around the page under the pointer, in the half it is drawn in as draw_pages does
+                    const auto left  = clicked_pos[1].x < width / 2.;
+                    const auto rtl   = config.spread == Spread::RightToLeft;
+                    draw_params.side = left ? DrawParameters::Side::Left : DrawParameters::Side::Right;
+                    anchor           = left != rtl ? dable : facing;
+                }
+                if(!anchor || anchor->state != Displayable::State::Loaded) {
+                    break;
+                }
+                anchor->zoom_by_drag(window, clicked_pos[1], value, draw_params);
                 draw_offset[0] = draw_params.offset[0];
                 draw_offset[1] = draw_params.offset[1];
                 draw_scale     = draw_params.scale;
                 do_refresh     = true;
+                if((dable && dable->reduced) || (facing && facing->reduced)) {
+                    pipeline.notify();
+                }
             } while(0);
         }
     }
     pointer_pos = pos;
     moved       = true;
     if(do_refresh) {
-        window->refresh();
+        request_redraw();
     }
     co_return true;
 }
@@ -350,60 +842,109 @@ auto Callbacks::on_click(const uint32_t button, const gawl::ButtonState state) -
         clicked_pos[i] = *pointer_pos;
     }
     if(clicked[i] == false && moved == false) {
-        change_page(false);
+        if(!grid_mode) {
+            change_page(false);
+        } else if(const auto index = pointer_pos ? grid.find_cell(*pointer_pos) : std::nullopt; index && i == 0) {
+            // open the clicked page
+            grid.select(*index);
+            close_grid(true);
+        }
     }
     moved = false;
     co_return true;
 }
 
 auto Callbacks::init(const int argc, const char* const argv[]) -> bool {
-    ensure(argc > 1);
-
-    const auto abs = std::filesystem::absolute(argv[1]);
-    if(argc == 2) {
-        if(std::filesystem::is_directory(argv[1])) {
-            unwrap_mut(l, list_files(abs.string()));
-            list = std::move(l);
-            filter_non_image_files(list);
-            ensure(!list.files.empty());
-        } else if(std::filesystem::is_regular_file(argv[1])) {
-            unwrap_mut(l, list_files(abs.parent_path().string()));
-            list = std::move(l);
-            filter_non_image_files(list);
+    unwrap(args, parse_args(argc, argv, config));
+    ensure(!args.empty());
+
+    const auto abs = std::filesystem::absolute(args[0]);
+    if(args.size() == 1) {
+        if(std::filesystem::is_directory(abs) || Archive::is_archive(abs.filename().string())) {
+            unwrap(l, dir_index.get(abs.string(), FileFilter::Images));
+            list = l;
             ensure(!list.files.empty());
-            for(auto i = 0uz; i < list.files.size(); i += 1) {
-                if(list.files[i] == abs.filename()) {
-                    list.index = i;
-                }
-            }
+        } else if(std::filesystem::is_regular_file(abs)) {
+            // show the file first, the directory is listed by lister_main
+            list    = FileList{abs.parent_path(), {abs.filename().string()}, 0};
+            live    = false;
+            listing = true;
         } else {
             bail("no such file");
         }
     } else {
+        live        = false;
         list.prefix = abs.parent_path();
-        for(auto i = 1; i < argc; i += 1) {
-            list.files.push_back(std::filesystem::path(argv[i]).filename());
+        for(const auto arg : args) {
+            list.files.push_back(std::filesystem::path(arg).filename().string());
         }
     }
 
-    cache.resize(list.files.size());
+    if(auto watcher = DirWatcher::open()) {
+        dir_watcher = std::move(*watcher);
+        watch_work();
+    }
+    if(config.readahead != 0) {
+        readahead.emplace(config.readahead_depth);
+    }
+    if(!config.trace.empty()) {
+        trace.emplace();
+    }
+    if(config.disk_cache != 0) {
+        unwrap(root, DiskCache::default_root());
+        auto ec = std::error_code();
+        std::filesystem::create_directories(root, ec);
+        ensure(!ec, "failed to create {}: {}", root.string(), ec.message());
+        disk_cache.emplace(root, config.disk_cache);
+        pipeline.set_disk_cache(&*disk_cache);
+    }
     return true;
 }
 
 auto Callbacks::on_created(gawl::Window* /*window*/) -> coop::Async<bool> {
     auto& runner = *(co_await coop::reveal_runner());
-    for(auto& handle : workers) {
-        runner.push_task(worker_main(), &handle);
+    pipeline.start(runner);
+    runner.push_task(resolver_main(), &resolver);
+    runner.push_task(player_main(), &player);
+    if(dir_watcher) {
+        runner.push_task(watcher_main(), &watcher);
+        runner.push_task(resyncer_main(), &resyncer);
+    }
+    if(listing) {
+        runner.push_task(lister_main(), &lister);
     }
+    runner.push_task(redrawer_main(), &redrawer);
+    grid.start(runner);
     co_return true;
 }
 
 Callbacks::Callbacks()
-    : font(gawl::TextRender({gawl::find_fontpath_from_name("Noto Sans CJK JP:style=Bold").value()}, 16)) {
+    : font(gawl::TextRender({gawl::find_fontpath_from_name("Noto Sans CJK JP:style=Bold").value()}, 16)),
+      grid([this]() { request_redraw(); }),
+      pipeline(
+          [this]() { return schedule(); },
+          [this](const Job& job) { return prioritize(job); },
+          [this](const std::function<bool()>& upload) {
+              auto context = std::bit_cast<gawl::WaylandWindow*>(window)->fork_context();
+              if(!upload()) {
+                  return false;
+              }
+              context.wait();
+              return true;
+          },
+          [this](std::shared_ptr<Job> job) { finish(std::move(job)); }) {
 }
 
 Callbacks::~Callbacks() {
-    for(auto& worker : workers) {
-        worker.cancel();
+    if(trace) {
+        trace->save(config.trace);
     }
+    pipeline.stop();
+    resolver.cancel();
+    player.cancel();
+    watcher.cancel();
+    resyncer.cancel();
+    lister.cancel();
+    redrawer.cancel();
+    grid.stop();
 }
@@ -1,28 +1,83 @@
 #pragma once
+#include <chrono>
+
 #include <coop/generator.hpp>
 #include <coop/multi-event.hpp>
 
+#include "config.hpp"
+#include "dir-index.hpp"
+#include "dir-watcher.hpp"
 #include "displayable/displayable.hpp"
 #include "file-list.hpp"
+#include "page-cache.hpp"
+#include "pipeline.hpp"
+#include "readahead.hpp"
+#include "thumbnail-grid.hpp"
 #include "gawl/textrender.hpp"
 #include "gawl/window-no-touch-callbacks.hpp"
 
 class Callbacks : public gawl::WindowNoTouchCallbacks {
   private:
-    using Cache = std::vector<std::shared_ptr<Displayable>>;
+    // text drawn over the page, measured only when the text changes
+    struct Overlay {
+        std::string     text;
+        gawl::Rectangle rect;
+    };
+    // what the info overlay was built from
+    struct InfoSource {
+        std::filesystem::path  prefix;
+        std::string            file;
+        size_t                 index;
+        size_t                 total;
+        size_t                 pages;
+        bool                   listing;
+        const Displayable*     timed;     // page whose timings are shown
+        TraceClock::time_point timed_end; // a preview keeps its displayable, the timings change when it is loaded
+    };
+
+    struct Neighbor {
+        std::filesystem::path   origin; // the work this neighbor was resolved from
+        std::optional<FileList> list;
+        PageCache               cache; // first pages of list
+    };
 
     gawl::TextRender                font;
+    Config                          config;
+    DirIndex                        dir_index;
+    std::optional<DiskCache>        disk_cache;
+    std::optional<Trace>            trace;
+    std::optional<DirWatcher>       dir_watcher; // follows list.prefix
+    std::optional<Readahead>        readahead;
     FileList                        list;
-    Cache                           cache;
+    PageCache                       cache;
     std::shared_ptr<Displayable>    last_displayed;
+    std::shared_ptr<Displayable>    last_facing; // the other page of the last drawn spread
     std::string                     page_jump_buffer;
     gawl::Point                     clicked_pos[2];
     std::optional<gawl::Point>      pointer_pos;
-    coop::MultiEvent                worker_event;
-    std::array<coop::TaskHandle, 4> workers;
+    std::array<Neighbor, 2>         neighbors; // next, prev
+    coop::MultiEvent                work_event;
+    coop::TaskHandle                resolver;
+    coop::MultiEvent                displayed_event; // the drawn page changed
+    coop::MultiEvent                loaded_event;    // a page of the current work was fully loaded
+    coop::TaskHandle                player;
+    coop::TaskHandle                watcher;
+    coop::MultiEvent                resync_event;
+    coop::TaskHandle                resyncer;
+    coop::TaskHandle                lister;
+    coop::MultiEvent                redraw_event;
+    coop::TaskHandle                redrawer;
+    std::optional<InfoSource>       info_source;
+    Overlay                         info_overlay;
+    std::optional<std::string>      jump_source; // page_jump_buffer the jump overlay was built from
+    Overlay                         jump_overlay;
+    ThumbnailGrid                   grid;
+    Pipeline                        pipeline;
 
-    constexpr static auto move_speed  = 60.0;
-    constexpr static auto cache_range = 4;
+    constexpr static auto move_speed     = 60.0;
+    constexpr static auto keep_range     = 1uz; // pages always kept regardless of the memory budget
+    constexpr static auto prefetch_pages = 2uz;
+    constexpr static auto frame_interval = std::chrono::microseconds(1'000'000 / 60);
 
     double draw_offset[2] = {0, 0};
     double draw_scale     = 0.0;
@@ -32,12 +87,47 @@ class Callbacks : public gawl::WindowNoTouchCallbacks {
     bool moved           = false;
     bool hide_info       = false;
     bool fill_background = false;
+    bool switching_work  = false;
+    bool upgrading       = false;
+    bool show_timings    = false;
+    bool live            = true;  // list mirrors the directory, false for files given on the command line
+    bool listing         = false; // list only holds the requested file until the directory is listed in the background
+    bool paging_reverse  = false; // direction of the last page change
+    bool redraw_pending  = false;
+    bool grid_mode       = false; // the thumbnail grid is shown instead of the pages
+    bool resync_pending  = false; // the watcher may have missed changes, e.g. made before the list was watched
 
     auto check_existence(bool reverse, FileList& files) -> bool;
+    auto view_pages() const -> size_t;
     auto change_page(bool reverse) -> void;
+    auto request_readahead() -> void;
     auto set_index_by_page_jump_buffer() -> bool;
     auto reset_draw_pos() -> void;
-    auto worker_main() -> coop::Async<void>;
+    auto create_displayable(std::string_view file, bool full_resolution) -> std::shared_ptr<Displayable>;
+    auto find_cache(const std::filesystem::path& work, size_t index, std::string_view file) -> PageCache*;
+    auto switch_work(FileList next, PageCache next_cache, bool reverse) -> void;
+    auto resolver_main() -> coop::Async<void>;
+    auto player_main() -> coop::Async<void>;
+    auto watch_work() -> void;
+    auto apply_dir_event(const DirWatcher::Event& event) -> bool;
+    auto apply_dir_events(const std::vector<DirWatcher::Event>& events) -> void;
+    auto diff_listing() -> coop::Async<std::vector<DirWatcher::Event>>;
+    auto watcher_main() -> coop::Async<void>;
+    auto resyncer_main() -> coop::Async<void>;
+    auto lister_main() -> coop::Async<void>;
+    auto schedule() -> std::shared_ptr<Job>;
+    auto prioritize(const Job& job) -> std::optional<size_t>;
+    auto finish(std::shared_ptr<Job> job) -> void;
+    auto request_redraw() -> void;
+    auto redrawer_main() -> coop::Async<void>;
+    auto set_overlay(Overlay& overlay, std::string text) -> void;
+    auto update_info_overlay(size_t pages) -> void;
+    auto draw_pages(const std::shared_ptr<Displayable>& first, const std::shared_ptr<Displayable>& second, DrawParameters params) -> void;
+    auto refresh_page() -> void;
+    auto quit() -> void;
+    auto open_grid() -> void;
+    auto close_grid(bool apply) -> void;
+    auto on_grid_keycode(uint32_t keycode) -> void;
 
   public:
     auto close() -> void override;
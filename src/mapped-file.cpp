@@ -0,0 +1,52 @@
+#include <bit>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "macros/assert.hpp"
+#include "mapped-file.hpp"
+
+auto MappedFile::open(const char* const path, const bool populate) -> std::optional<MappedFile> {
+    const auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    ensure(fd >= 0, "failed to open {}", path);
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        bail("failed to stat {}", path);
+    }
+    auto file = MappedFile();
+    if(st.st_size == 0) {
+        close(fd);
+        return file;
+    }
+    if(populate) {
+        // larger readahead window
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    const auto ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+    close(fd);
+    ensure(ptr != MAP_FAILED, "failed to map {}", path);
+    file.data = std::bit_cast<std::byte*>(ptr);
+    file.size = size_t(st.st_size);
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& o)
+    : data(std::exchange(o.data, nullptr)),
+      size(std::exchange(o.size, 0)) {}
+
+auto MappedFile::operator=(MappedFile&& o) -> MappedFile& {
+    std::swap(data, o.data);
+    std::swap(size, o.size);
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if(data != nullptr) {
+        munmap(data, size);
+    }
+}
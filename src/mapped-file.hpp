@@ -0,0 +1,23 @@
+#pragma once
+#include <optional>
+#include <span>
+
+// read-only memory mapping of a whole file
+class MappedFile {
+  private:
+    std::byte* data = nullptr;
+    size_t     size = 0;
+
+  public:
+    // populate: read the whole file into the page cache now instead of faulting pages in later
+    static auto open(const char* path, bool populate = false) -> std::optional<MappedFile>;
+
+    auto get() const -> std::span<const std::byte> {
+        return {data, size};
+    }
+
+    MappedFile() = default;
+    MappedFile(MappedFile&& o);
+    auto operator=(MappedFile&& o) -> MappedFile&;
+    ~MappedFile();
+};
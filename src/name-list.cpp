@@ -0,0 +1,69 @@
+#include <algorithm>
+
+#include "name-list.hpp"
+
+// a directory listing never comes close to 4GiB of names, offsets are kept 32bit to halve the index
+auto NameList::append(const std::string_view name) -> Span {
+    const auto span = Span{uint32_t(arena.size()), uint32_t(name.size())};
+    arena.append(name);
+    return span;
+}
+
+// drops erased names once they take more than half of the arena
+auto NameList::compact() -> void {
+    if(garbage * 2 <= arena.size()) {
+        return;
+    }
+    auto packed = std::string();
+    packed.reserve(arena.size() - garbage);
+    for(auto& span : spans) {
+        const auto offset = uint32_t(packed.size());
+        packed.append(arena, span.offset, span.size);
+        span.offset       = offset;
+    }
+    arena   = std::move(packed);
+    garbage = 0;
+}
+
+auto NameList::operator==(const NameList& other) const -> bool {
+    return std::ranges::equal(*this, other);
+}
+
+auto NameList::reserve(const size_t count, const size_t bytes) -> void {
+    spans.reserve(count);
+    arena.reserve(bytes);
+}
+
+auto NameList::push_back(const std::string_view name) -> void {
+    spans.push_back(append(name));
+}
+
+auto NameList::insert(const size_t index, const std::string_view name) -> void {
+    // the name goes to the end of the arena, only the spans are shifted
+    spans.insert(spans.begin() + index, append(name));
+}
+
+auto NameList::erase(const size_t index) -> void {
+    garbage += spans[index].size;
+    spans.erase(spans.begin() + index);
+    compact();
+}
+
+auto NameList::reorder(const std::span<const size_t> order) -> void {
+    // only the spans move, names not in order are left in the arena as garbage
+    auto reordered = std::vector<Span>(order.size());
+    auto used      = 0uz;
+    for(auto i = 0uz; i < order.size(); i += 1) {
+        reordered[i]  = spans[order[i]];
+        used         += reordered[i].size;
+    }
+    spans   = std::move(reordered);
+    garbage = arena.size() - used;
+    compact();
+}
+
+NameList::NameList(const std::initializer_list<std::string_view> names) {
+    for(const auto name : names) {
+        push_back(name);
+    }
+}
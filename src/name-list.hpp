@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// file names packed back to back in a single buffer
+// each name costs its bytes plus an 8 byte span, instead of a std::string and usually a heap block of its own
+class NameList {
+  private:
+    struct Span {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    std::string       arena;
+    std::vector<Span> spans;
+    size_t            garbage = 0; // bytes of erased names still in arena
+
+    auto append(std::string_view name) -> Span;
+    auto compact() -> void;
+
+  public:
+    class Iterator {
+      private:
+        const NameList* list  = nullptr;
+        size_t          index = 0;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = ptrdiff_t;
+
+        auto operator*() const -> std::string_view {
+            return (*list)[index];
+        }
+
+        auto operator[](const difference_type n) const -> std::string_view {
+            return (*list)[index + n];
+        }
+
+        auto operator++() -> Iterator& {
+            index += 1;
+            return *this;
+        }
+
+        auto operator++(int) -> Iterator {
+            auto ret = *this;
+            index   += 1;
+            return ret;
+        }
+
+        auto operator--() -> Iterator& {
+            index -= 1;
+            return *this;
+        }
+
+        auto operator--(int) -> Iterator {
+            auto ret = *this;
+            index   -= 1;
+            return ret;
+        }
+
+        auto operator+=(const difference_type n) -> Iterator& {
+            index += n;
+            return *this;
+        }
+
+        auto operator-=(const difference_type n) -> Iterator& {
+            index -= n;
+            return *this;
+        }
+
+        auto operator+(const difference_type n) const -> Iterator {
+            return Iterator(list, index + n);
+        }
+
+        friend auto operator+(const difference_type n, const Iterator& it) -> Iterator {
+            return it + n;
+        }
+
+        auto operator-(const difference_type n) const -> Iterator {
+            return Iterator(list, index - n);
+        }
+
+        auto operator-(const Iterator& other) const -> difference_type {
+            return difference_type(index) - difference_type(other.index);
+        }
+
+        auto operator==(const Iterator& other) const -> bool {
+            return index == other.index;
+        }
+
+        auto operator<=>(const Iterator& other) const -> std::strong_ordering {
+            return index <=> other.index;
+        }
+
+        Iterator() = default;
+        Iterator(const NameList* const list, const size_t index)
+            : list(list),
+              index(index) {}
+    };
+
+    auto size() const -> size_t {
+        return spans.size();
+    }
+
+    auto empty() const -> bool {
+        return spans.empty();
+    }
+
+    auto operator[](const size_t index) const -> std::string_view {
+        const auto span = spans[index];
+        return std::string_view(arena.data() + span.offset, span.size);
+    }
+
+    auto begin() const -> Iterator {
+        return Iterator(this, 0);
+    }
+
+    auto end() const -> Iterator {
+        return Iterator(this, spans.size());
+    }
+
+    auto operator==(const NameList& other) const -> bool;
+
+    auto reserve(size_t count, size_t bytes) -> void;
+    auto push_back(std::string_view name) -> void;
+    auto insert(size_t index, std::string_view name) -> void;
+    auto erase(size_t index) -> void;
+    // names[i] becomes names[order[i]], indices missing from order are dropped
+    auto reorder(std::span<const size_t> order) -> void;
+
+    template <class Pred>
+    auto erase_if(const Pred pred) -> void {
+        auto order = std::vector<size_t>();
+        order.reserve(spans.size());
+        for(auto i = 0uz; i < spans.size(); i += 1) {
+            if(!pred((*this)[i])) {
+                order.push_back(i);
+            }
+        }
+        reorder(order);
+    }
+
+    NameList() = default;
+    NameList(std::initializer_list<std::string_view> names);
+};
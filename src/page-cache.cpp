@@ -0,0 +1,206 @@
+#include <algorithm>
+
+#include "page-cache.hpp"
+#include "renumber.hpp"
+
+namespace {
+auto distance(const size_t a, const size_t b) -> size_t {
+    return a > b ? a - b : b - a;
+}
+} // namespace
+
+auto PageCache::average_size() const -> size_t {
+    constexpr auto default_size = 32uz * 1024 * 1024;
+    if(known_sizes.empty()) {
+        return default_size;
+    }
+    return known_total / known_sizes.size();
+}
+
+auto PageCache::contains(const size_t index) const -> bool {
+    return entries.contains(index);
+}
+
+auto PageCache::get(const size_t index) -> std::shared_ptr<Displayable> {
+    const auto it = entries.find(index);
+    if(it == entries.end()) {
+        return nullptr;
+    }
+    tick += 1;
+    it->second.last_used = tick;
+    return it->second.displayable;
+}
+
+auto PageCache::peek(const size_t index) const -> Displayable* {
+    const auto it = entries.find(index);
+    return it != entries.end() ? it->second.displayable.get() : nullptr;
+}
+
+auto PageCache::set(const size_t index, std::shared_ptr<Displayable> displayable) -> void {
+    erase(index);
+    const auto loaded = displayable->state == Displayable::State::Loaded;
+    const auto bytes  = loaded ? displayable->get_size() : 0;
+    if(loaded) {
+        auto& known  = known_sizes[index];
+        known_total += bytes - known;
+        known        = bytes;
+    }
+    used += bytes;
+    tick += 1;
+    entries.emplace(index, Entry{std::move(displayable), bytes, tick});
+}
+
+auto PageCache::erase(const size_t index) -> void {
+    const auto it = entries.find(index);
+    if(it == entries.end()) {
+        return;
+    }
+    used -= it->second.bytes;
+    entries.erase(it);
+}
+
+auto PageCache::truncate(const size_t count) -> void {
+    std::erase_if(entries, [this, count](const auto& pair) {
+        if(pair.first < count) {
+            return false;
+        }
+        used -= pair.second.bytes;
+        return true;
+    });
+}
+
+auto PageCache::drop_loading(const size_t first) -> void {
+    std::erase_if(entries, [first](const auto& pair) { return pair.first >= first && pair.second.bytes == 0; });
+}
+
+auto PageCache::insert_slot(const size_t index) -> void {
+    drop_loading(index);
+    const auto shift = [index](const size_t i) { return i >= index ? i + 1 : i; };
+    renumber(entries, shift);
+    renumber(known_sizes, shift);
+}
+
+auto PageCache::remove_slot(const size_t index) -> void {
+    erase(index);
+    drop_loading(index);
+    if(const auto it = known_sizes.find(index); it != known_sizes.end()) {
+        known_total -= it->second;
+        known_sizes.erase(it);
+    }
+    const auto shift = [index](const size_t i) { return i > index ? i - 1 : i; };
+    renumber(entries, shift);
+    renumber(known_sizes, shift);
+}
+
+auto PageCache::estimate(const size_t index) const -> size_t {
+    if(const auto it = entries.find(index); it != entries.end() && it->second.bytes != 0) {
+        return it->second.bytes;
+    }
+    if(const auto it = known_sizes.find(index); it != known_sizes.end()) {
+        return it->second;
+    }
+    return average_size();
+}
+
+auto PageCache::evict(const size_t center, const size_t keep_range, const size_t budget) -> void {
+    while(used > budget) {
+        auto victim = entries.end();
+        for(auto it = entries.begin(); it != entries.end(); it = std::next(it)) {
+            const auto d = distance(it->first, center);
+            if(it->second.bytes == 0 || d <= keep_range) {
+                continue;
+            }
+            if(victim == entries.end()) {
+                victim = it;
+                continue;
+            }
+            const auto vd = distance(victim->first, center);
+            if(d > vd || (d == vd && it->second.last_used < victim->second.last_used)) {
+                victim = it;
+            }
+        }
+        if(victim == entries.end()) {
+            return;
+        }
+        used -= victim->second.bytes;
+        entries.erase(victim);
+    }
+}
+
+template <class Func>
+auto PageCache::walk(const size_t center, const size_t count, const size_t keep_range, const size_t budget, const Func func) const -> std::optional<size_t> {
+    const auto range = std::max(center + 1, count - center);
+    auto       used  = 0uz;
+    for(auto d = 0uz; d < range; d += 1) {
+        for(auto backward = (d == 0 ? 1 : 0); backward < 2; backward += 1) {
+            if(backward == 1 ? d > center : center + d >= count) {
+                continue;
+            }
+            const auto i     = backward == 1 ? center - d : center + d;
+            const auto bytes = estimate(i);
+            if(d > keep_range && used + bytes > budget) {
+                return std::nullopt;
+            }
+            used += bytes;
+            if(func(i)) {
+                return i;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+auto PageCache::next_missing(const size_t center, const size_t count, const size_t keep_range, const size_t budget) const -> std::optional<size_t> {
+    if(count == 0) {
+        return std::nullopt;
+    }
+    return walk(center, count, keep_range, budget, [this](const size_t i) { return !contains(i); });
+}
+
+auto PageCache::within_budget(const size_t index, const size_t center, const size_t count, const size_t keep_range, const size_t budget) const -> bool {
+    if(index >= count) {
+        return false;
+    }
+    return walk(center, count, keep_range, budget, [index](const size_t i) { return i == index; }).has_value();
+}
+
+auto PageCache::next_claim(const size_t center, const size_t pages, const size_t count, const size_t keep_range, const size_t budget) const -> std::optional<size_t> {
+    // the pages on screen first, so that both halves of a spread are read together
+    for(auto i = center; i < std::min(center + pages, count); i += 1) {
+        if(!contains(i)) {
+            return i;
+        }
+    }
+    return next_missing(center, count, keep_range, budget);
+}
+
+auto PageCache::priority(const size_t index, const size_t center, const size_t pages, const size_t count, const size_t keep_range, const size_t budget) const -> std::optional<size_t> {
+    // distance from the pages on screen, a spread is decoded as one unit
+    const auto last = center + std::max(1uz, pages) - 1;
+    if(index >= center && index <= last) {
+        return 0;
+    }
+    if(!within_budget(index, center, count, keep_range, budget)) {
+        // paged away
+        return std::nullopt;
+    }
+    return index < center ? center - index : index - last;
+}
+
+auto PageCache::beyond_budget(const size_t center, const bool reverse, const size_t limit, const size_t count, const size_t keep_range, const size_t budget) const -> std::vector<size_t> {
+    auto ret = std::vector<size_t>();
+    for(auto i = center; ret.size() < limit;) {
+        if(reverse ? i == 0 : i + 1 >= count) {
+            break;
+        }
+        i += reverse ? -1 : 1;
+        if(!contains(i) && !within_budget(i, center, count, keep_range, budget)) {
+            ret.push_back(i);
+        }
+    }
+    return ret;
+}
+
+auto PageCache::get_used() const -> size_t {
+    return used;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "displayable/displayable.hpp"
+
+// pages of a work keyed by page index
+// only claimed or loaded pages have an entry, so the cost does not depend on the directory size
+class PageCache {
+  private:
+    struct Entry {
+        std::shared_ptr<Displayable> displayable;
+        size_t                       bytes; // 0 while loading
+        size_t                       last_used;
+    };
+
+    std::unordered_map<size_t, Entry>  entries;
+    std::unordered_map<size_t, size_t> known_sizes; // decoded size of pages seen before, to avoid reloading pages that do not fit
+    size_t                             known_total = 0;
+    size_t                             used        = 0;
+    size_t                             tick        = 0;
+
+    auto average_size() const -> size_t;
+    auto drop_loading(size_t first) -> void;
+    // visits pages outward from center while they fit in budget, returns the first page func accepts
+    template <class Func>
+    auto walk(size_t center, size_t count, size_t keep_range, size_t budget, Func func) const -> std::optional<size_t>;
+
+  public:
+    auto contains(size_t index) const -> bool;
+    // marks the page as recently used
+    auto get(size_t index) -> std::shared_ptr<Displayable>;
+    // returns the entry without touching it
+    auto peek(size_t index) const -> Displayable*;
+    // loaded displayables are accounted with their byte size
+    auto set(size_t index, std::shared_ptr<Displayable> displayable) -> void;
+    auto erase(size_t index) -> void;
+    // drops pages at or after count
+    auto truncate(size_t count) -> void;
+    // a file was inserted into or removed from the work, moves the pages after it to their new index
+    // moved pages still loading are dropped, since their jobs refer to the old index
+    auto insert_slot(size_t index) -> void;
+    auto remove_slot(size_t index) -> void;
+    // byte size of the page if known, otherwise a guess
+    auto estimate(size_t index) const -> size_t;
+    // evicts far and least recently used pages until the cache fits in budget
+    // pages within keep_range from center are never evicted
+    auto evict(size_t center, size_t keep_range, size_t budget) -> void;
+    // nearest page from center which is missing and fits in budget together with the pages closer to center
+    // count: number of pages in the work
+    auto next_missing(size_t center, size_t count, size_t keep_range, size_t budget) const -> std::optional<size_t>;
+    // whether the page would still be loaded by next_missing
+    auto within_budget(size_t index, size_t center, size_t count, size_t keep_range, size_t budget) const -> bool;
+    // page to claim next, the pages on screen and then next_missing
+    // pages: number of pages on screen from center
+    auto next_claim(size_t center, size_t pages, size_t count, size_t keep_range, size_t budget) const -> std::optional<size_t>;
+    // decode order of a claimed page, nullopt once next_claim would no longer pick it
+    auto priority(size_t index, size_t center, size_t pages, size_t count, size_t keep_range, size_t budget) const -> std::optional<size_t>;
+    // up to limit pages past the ones next_missing would load, nearest first in the paging direction, for reading ahead
+    auto beyond_budget(size_t center, bool reverse, size_t limit, size_t count, size_t keep_range, size_t budget) const -> std::vector<size_t>;
+    auto get_used() const -> size_t;
+};
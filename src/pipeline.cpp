@@ -0,0 +1,188 @@
+#include <cerrno>
+#include <optional>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <coop/thread.hpp>
+
+#include "macros/unwrap.hpp"
+#include "pipeline.hpp"
+
+namespace {
+// smaller files are read, larger ones are mapped to save the copy
+constexpr auto mmap_threshold = 16uz * 1024 * 1024;
+
+auto decoder_count() -> size_t {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+auto read_file(const std::filesystem::path& path, const size_t size) -> std::optional<std::vector<std::byte>> {
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    ensure(fd >= 0, "failed to open {}", path.string());
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    auto data = std::vector<std::byte>(size);
+    auto done = 0uz;
+    while(done < size) {
+        const auto len = read(fd, data.data() + done, size - done);
+        if(len < 0 && errno == EINTR) {
+            continue;
+        }
+        if(len <= 0) {
+            break;
+        }
+        done += size_t(len);
+    }
+    close(fd);
+    ensure(done == size, "failed to read {}", path.string());
+    return data;
+}
+} // namespace
+
+auto read_page(const Archive* const archive, const std::string& file, const std::filesystem::path& path) -> std::optional<FileData> {
+    if(archive != nullptr) {
+        return archive->read(file);
+    }
+    auto       ec   = std::error_code();
+    const auto size = std::filesystem::file_size(path, ec);
+    ensure(!ec, "failed to stat {}: {}", path.string(), ec.message());
+    if(size < mmap_threshold) {
+        unwrap_mut(data, read_file(path, size));
+        auto owner = std::make_shared<std::vector<std::byte>>(std::move(data));
+        return FileData{owner, *owner};
+    }
+    unwrap_mut(mapped, MappedFile::open(path.c_str(), true));
+    auto owner = std::make_shared<MappedFile>(std::move(mapped));
+    return FileData{owner, owner->get(), true};
+}
+
+auto Pipeline::read_main() -> coop::Async<void> {
+loop:
+    const auto job = scheduler();
+    if(!job) {
+        co_await schedule_event;
+        goto loop;
+    }
+
+    // pages are claimed only when the reader is free, so there is no wait before the read
+    const auto path        = job->work / job->file;
+    job->timing.claimed    = TraceClock::now();
+    job->timing.read_begin = job->timing.claimed;
+    if(disk_cache != nullptr && co_await coop::run_blocking([this, &job, &path]() { return job->displayable->restore(*disk_cache, path); })) {
+        job->timing.read_end = TraceClock::now();
+        co_await upload_queue.push(job);
+        goto loop;
+    }
+    auto data            = co_await coop::run_blocking([&job, &path]() { return read_page(job->archive.get(), job->file, path); });
+    job->timing.read_end = TraceClock::now();
+    if(data) {
+        job->data = std::move(*data);
+    } else {
+        job->ok = false;
+    }
+    co_await decode_queue.push(job);
+    goto loop;
+}
+
+auto Pipeline::decode_main(const size_t decoder) -> coop::Async<void> {
+loop:
+    const auto job = co_await decode_queue.pop();
+    if(job->ok) {
+        job->timing.decoder      = decoder;
+        job->timing.decode_begin = TraceClock::now();
+        // previews only for the pages on screen, for the others the full decode comes before they are drawn
+        // upgrades already have the reduced page drawn
+        // a preview is worthless once late, so it is dropped rather than holding back the full decode when the uploader is busy
+        const auto on_screen = job->replaces == nullptr && prioritizer(*job) == 0uz;
+        if(on_screen && co_await coop::run_blocking([&job]() { return job->displayable->decode_preview(job->data.bytes); })) {
+            upload_queue.try_push(std::shared_ptr<Job>(new Job{.work = job->work, .index = job->index, .file = job->file, .archive = job->archive, .displayable = job->displayable, .preview = true}));
+        }
+        job->displayable->keep_pixels = disk_cache != nullptr;
+        job->ok                       = co_await coop::run_blocking([&job]() { return job->displayable->decode(job->data); });
+        job->data              = FileData();
+        job->timing.decode_end = TraceClock::now();
+    }
+    co_await upload_queue.push(job);
+    goto loop;
+}
+
+auto Pipeline::upload_main() -> coop::Async<void> {
+loop:
+    const auto job = co_await upload_queue.pop();
+    if(job->ok) {
+        job->timing.upload_begin = TraceClock::now();
+        job->ok                  = co_await coop::run_blocking([this, &job]() -> bool {
+            auto& displayable = *job->displayable;
+            return uploader([&displayable, preview = job->preview]() { return preview ? displayable.upload_preview() : displayable.upload(); });
+        });
+        job->timing.upload_end = TraceClock::now();
+    }
+    if(job->ok && !job->preview && job->displayable->keep_pixels) {
+        store_queue.push_back(Store{job->displayable, job->work / job->file});
+        store_event.notify();
+    }
+    finisher(job);
+    goto loop;
+}
+
+auto Pipeline::store_main() -> coop::Async<void> {
+loop:
+    if(store_queue.empty()) {
+        co_await store_event;
+        goto loop;
+    }
+    const auto store = std::move(store_queue.front());
+    store_queue.erase(store_queue.begin());
+    co_await coop::run_blocking([this, &store]() { store.displayable->store(*disk_cache, store.path); });
+    goto loop;
+}
+
+auto Pipeline::cancel(std::shared_ptr<Job> job) -> void {
+    job->ok        = false;
+    job->cancelled = true;
+    finisher(std::move(job));
+}
+
+auto Pipeline::set_disk_cache(DiskCache* const cache) -> void {
+    disk_cache = cache;
+}
+
+auto Pipeline::notify() -> void {
+    schedule_event.notify();
+    decode_queue.wake();
+    upload_queue.wake();
+}
+
+auto Pipeline::start(coop::Runner& runner) -> void {
+    runner.push_task(read_main(), &read_task);
+    decode_tasks.resize(decoder_count());
+    for(auto i = 0uz; i < decode_tasks.size(); i += 1) {
+        runner.push_task(decode_main(i), &decode_tasks[i]);
+    }
+    runner.push_task(upload_main(), &upload_task);
+    runner.push_task(store_main(), &store_task);
+}
+
+auto Pipeline::stop() -> void {
+    read_task.cancel();
+    for(auto& handle : decode_tasks) {
+        handle.cancel();
+    }
+    upload_task.cancel();
+    store_task.cancel();
+}
+
+Pipeline::Pipeline(Scheduler scheduler, Prioritizer prioritizer, Uploader uploader, Finisher finisher)
+    : scheduler(std::move(scheduler)),
+      prioritizer(std::move(prioritizer)),
+      uploader(std::move(uploader)),
+      finisher(std::move(finisher)),
+      decode_queue(
+          decoder_count(),
+          [this](const std::shared_ptr<Job>& job) { return this->prioritizer(*job); },
+          [this](std::shared_ptr<Job> job) { cancel(std::move(job)); }),
+      upload_queue(
+          2,
+          [this](const std::shared_ptr<Job>& job) { return this->prioritizer(*job); },
+          [this](std::shared_ptr<Job> job) { cancel(std::move(job)); }) {}
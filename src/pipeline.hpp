@@ -0,0 +1,81 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+#include <coop/task-handle.hpp>
+
+#include "displayable/displayable.hpp"
+#include "archive.hpp"
+#include "file-data.hpp"
+#include "queue.hpp"
+#include "trace.hpp"
+
+struct Job {
+    std::filesystem::path          work;
+    size_t                         index;
+    std::string                    file;
+    std::shared_ptr<const Archive> archive; // set if work is an archive
+    std::shared_ptr<Displayable>   displayable;
+    Displayable*                   replaces  = nullptr; // the cached page this job upgrades
+    FileData                       data      = {};
+    bool                           ok        = true;
+    bool                           cancelled = false;
+    bool                           preview   = false; // carries the preview of a job still decoding
+    PageTiming                     timing    = {};
+};
+
+// file may be a member of archive, path is then ignored
+// large files are returned mapped, the mapping should be released once decoded
+auto read_page(const Archive* archive, const std::string& file, const std::filesystem::path& path) -> std::optional<FileData>;
+
+// read -> decode -> upload -> store
+// the reader pulls jobs from the scheduler, decoders run in parallel, a single uploader touches the gl context
+// decoded pages are written to the disk cache after they are shown, off the path of the next page
+// queued jobs are reordered by the prioritizer and dropped once they become stale
+class Pipeline {
+  public:
+    using Scheduler   = std::function<std::shared_ptr<Job>()>;             // returns null if there is nothing to do
+    using Prioritizer = std::function<std::optional<size_t>(const Job&)>;  // lower first, nullopt if stale
+    using Uploader    = std::function<bool(const std::function<bool()>&)>; // runs gpu work with a gl context, called from a blocking thread
+    using Finisher    = std::function<void(std::shared_ptr<Job>)>;          // also receives cancelled jobs
+
+  private:
+    // a page waiting to be written to the disk cache
+    struct Store {
+        std::shared_ptr<Displayable> displayable;
+        std::filesystem::path        path;
+    };
+
+    Scheduler                           scheduler;
+    Prioritizer                         prioritizer;
+    Uploader                            uploader;
+    Finisher                            finisher;
+    PriorityQueue<std::shared_ptr<Job>> decode_queue;
+    PriorityQueue<std::shared_ptr<Job>> upload_queue;
+    coop::MultiEvent                    schedule_event;
+    coop::TaskHandle                    read_task;
+    std::vector<coop::TaskHandle>       decode_tasks;
+    coop::TaskHandle                    upload_task;
+    std::vector<Store>                  store_queue;
+    coop::MultiEvent                    store_event;
+    coop::TaskHandle                    store_task;
+    DiskCache*                          disk_cache = nullptr;
+
+    auto cancel(std::shared_ptr<Job> job) -> void;
+
+    auto read_main() -> coop::Async<void>;
+    auto decode_main(size_t decoder) -> coop::Async<void>;
+    auto upload_main() -> coop::Async<void>;
+    auto store_main() -> coop::Async<void>;
+
+  public:
+    // optional, pages found there skip reading and decoding
+    auto set_disk_cache(DiskCache* cache) -> void;
+    // wake up the reader and reorder queued jobs after the schedule changed
+    auto notify() -> void;
+    auto start(coop::Runner& runner) -> void;
+    auto stop() -> void;
+
+    Pipeline(Scheduler scheduler, Prioritizer prioritizer, Uploader uploader, Finisher finisher);
+};
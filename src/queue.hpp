@@ -0,0 +1,94 @@
+#pragma once
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include <coop/generator.hpp>
+#include <coop/multi-event.hpp>
+
+// bounded queue shared between coroutines on the same runner
+// items are popped in order of priority(lower first), items without a priority are stale and handed to drop
+template <class T>
+class PriorityQueue {
+  public:
+    using Priority = std::function<std::optional<size_t>(const T&)>;
+    using Drop     = std::function<void(T)>;
+
+  private:
+    std::vector<T>   items;
+    size_t           capacity;
+    Priority         priority;
+    Drop             drop;
+    coop::MultiEvent changed;
+
+    auto purge() -> void {
+        for(auto i = 0uz; i < items.size();) {
+            if(priority(items[i])) {
+                i += 1;
+                continue;
+            }
+            auto item = std::move(items[i]);
+            items.erase(items.begin() + i);
+            drop(std::move(item));
+        }
+    }
+
+  public:
+    auto push(T item) -> coop::Async<void> {
+        if(!priority(item)) {
+            drop(std::move(item));
+            co_return;
+        }
+    loop:
+        purge();
+        if(items.size() >= capacity) {
+            co_await changed;
+            goto loop;
+        }
+        items.push_back(std::move(item));
+        changed.notify();
+    }
+
+    // does not wait, returns false if the queue is full or the item is stale
+    // the item is discarded then without being handed to drop
+    auto try_push(T item) -> bool {
+        purge();
+        if(!priority(item) || items.size() >= capacity) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        changed.notify();
+        return true;
+    }
+
+    auto pop() -> coop::Async<T> {
+    loop:
+        purge();
+        if(items.empty()) {
+            co_await changed;
+            goto loop;
+        }
+        auto best      = 0uz;
+        auto best_prio = *priority(items[0]);
+        for(auto i = 1uz; i < items.size(); i += 1) {
+            if(const auto prio = *priority(items[i]); prio < best_prio) {
+                best      = i;
+                best_prio = prio;
+            }
+        }
+        auto item = std::move(items[best]);
+        items.erase(items.begin() + best);
+        changed.notify();
+        co_return item;
+    }
+
+    // priorities may have changed
+    auto wake() -> void {
+        changed.notify();
+    }
+
+    PriorityQueue(const size_t capacity, Priority priority, Drop drop)
+        : capacity(capacity),
+          priority(std::move(priority)),
+          drop(std::move(drop)) {}
+};
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(IMGVIEW_URING)
+#include <liburing.h>
+#endif
+
+#include "readahead.hpp"
+
+namespace {
+constexpr auto chunk_size = 512uz * 1024;
+constexpr auto max_recent = 64uz;
+
+auto open_file(const std::string& path, size_t& size) -> int {
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return -1;
+    }
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    size = size_t(st.st_size);
+    return fd;
+}
+} // namespace
+
+auto Readahead::pop(const bool wait) -> std::string {
+    auto guard = std::unique_lock(lock);
+    if(wait) {
+        cond.wait(guard, [this]() { return quit || !pending.empty(); });
+    }
+    if(quit || pending.empty()) {
+        return {};
+    }
+    auto path = std::move(pending.front());
+    pending.pop_front();
+    recent.push_back(path);
+    if(recent.size() > max_recent) {
+        recent.pop_front();
+    }
+    return path;
+}
+
+auto Readahead::thread_main() -> void {
+    auto buffer = std::vector<std::byte>(chunk_size);
+loop:
+    const auto path = pop(true);
+    if(path.empty()) {
+        return;
+    }
+    auto size = 0uz;
+    if(const auto fd = open_file(path, size); fd >= 0) {
+        for(auto offset = 0uz; offset < size;) {
+            const auto len = pread(fd, buffer.data(), buffer.size(), off_t(offset));
+            if(len <= 0) {
+                break;
+            }
+            offset += size_t(len);
+        }
+        close(fd);
+    }
+    goto loop;
+}
+
+#if defined(IMGVIEW_URING)
+// one thread keeps depth chunk reads in flight, across files
+auto Readahead::uring_main(const std::unique_ptr<io_uring> ring_) -> void {
+    struct File {
+        int    fd;
+        size_t size;
+        size_t next      = 0; // offset of the next chunk to submit
+        size_t in_flight = 0;
+    };
+    struct Slot {
+        File*                  file = nullptr; // null if free
+        std::vector<std::byte> buffer;
+    };
+
+    auto& ring    = *ring_;
+    auto  slots   = std::vector<Slot>(depth);
+    auto  files   = std::vector<std::unique_ptr<File>>();
+    auto  current = (File*)(nullptr); // file being submitted
+    auto  busy    = 0uz;
+    for(auto& slot : slots) {
+        slot.buffer.resize(chunk_size);
+    }
+    const auto release = [&files](File* const file) {
+        if(file->next >= file->size && file->in_flight == 0) {
+            close(file->fd);
+            std::erase_if(files, [file](const auto& ptr) { return ptr.get() == file; });
+        }
+    };
+
+loop:
+    // fill free slots
+    for(auto& slot : slots) {
+        if(slot.file != nullptr) {
+            continue;
+        }
+        while(current == nullptr || current->next >= current->size) {
+            if(current != nullptr) {
+                const auto done = current;
+                current         = nullptr;
+                release(done);
+            }
+            // only block when nothing is in flight
+            const auto path = pop(busy == 0);
+            if(path.empty()) {
+                break;
+            }
+            auto size = 0uz;
+            if(const auto fd = open_file(path, size); fd >= 0) {
+                current = files.emplace_back(new File{fd, size}).get();
+            }
+        }
+        if(current == nullptr) {
+            break;
+        }
+        const auto len = std::min(chunk_size, current->size - current->next);
+        const auto sqe = io_uring_get_sqe(&ring);
+        io_uring_prep_read(sqe, current->fd, slot.buffer.data(), unsigned(len), current->next);
+        io_uring_sqe_set_data(sqe, &slot);
+        slot.file           = current;
+        current->next      += len;
+        current->in_flight += 1;
+        busy               += 1;
+    }
+    if(busy == 0) {
+        // quitting
+        if(current != nullptr) {
+            close(current->fd);
+        }
+        io_uring_queue_exit(&ring);
+        return;
+    }
+    io_uring_submit(&ring);
+
+    // reap one completion, short reads only mean the file shrank
+    auto cqe = (io_uring_cqe*)(nullptr);
+    if(io_uring_wait_cqe(&ring, &cqe) == 0) {
+        auto&      slot = *std::bit_cast<Slot*>(io_uring_cqe_get_data(cqe));
+        const auto file = slot.file;
+        io_uring_cqe_seen(&ring, cqe);
+        slot.file        = nullptr;
+        file->in_flight -= 1;
+        busy            -= 1;
+        if(file != current) {
+            release(file);
+        }
+    }
+    goto loop;
+}
+#endif
+
+auto Readahead::request(std::vector<std::string> paths) -> void {
+    {
+        const auto guard = std::lock_guard(lock);
+        std::erase_if(paths, [this](const std::string& path) { return std::ranges::find(recent, path) != recent.end(); });
+        pending.assign(std::make_move_iterator(paths.begin()), std::make_move_iterator(paths.end()));
+    }
+    cond.notify_all();
+}
+
+Readahead::Readahead(const size_t depth)
+    : depth(std::max(1uz, depth)) {
+#if defined(IMGVIEW_URING)
+    // io_uring may be disabled by the kernel or a seccomp filter, fall back to threads then
+    if(auto ring = std::make_unique<io_uring>(); io_uring_queue_init(unsigned(this->depth), ring.get(), 0) == 0) {
+        threads.emplace_back([this, ring = std::move(ring)]() mutable { uring_main(std::move(ring)); });
+        return;
+    }
+#endif
+    for(auto i = 0uz; i < this->depth; i += 1) {
+        threads.emplace_back([this]() { thread_main(); });
+    }
+}
+
+Readahead::~Readahead() {
+    {
+        const auto guard = std::lock_guard(lock);
+        quit             = true;
+    }
+    cond.notify_all();
+    for(auto& thread : threads) {
+        thread.join();
+    }
+}
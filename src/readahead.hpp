@@ -0,0 +1,36 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// reads files which are about to be opened, so that their pages are already in the kernel page cache
+// a thread per queue slot, or io_uring if built with the io_uring option
+class Readahead {
+  private:
+    std::mutex               lock;
+    std::condition_variable  cond;
+    std::deque<std::string>  pending;
+    std::deque<std::string>  recent; // files read lately, not requested again
+    std::vector<std::thread> threads;
+    size_t                   depth;
+    bool                     quit = false;
+
+    // blocks until a file is requested if wait is set, returns an empty string when quitting or if nothing is pending
+    auto pop(bool wait) -> std::string;
+    auto thread_main() -> void;
+#if defined(IMGVIEW_URING)
+    auto uring_main(std::unique_ptr<struct io_uring> ring) -> void;
+#endif
+
+  public:
+    // files are read in order, requests not started yet are replaced
+    auto request(std::vector<std::string> paths) -> void;
+
+    // depth: number of reads in flight
+    Readahead(size_t depth);
+    ~Readahead();
+};
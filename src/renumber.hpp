@@ -0,0 +1,24 @@
+#pragma once
+#include <unordered_set>
+#include <utility>
+
+// rekeys every entry of an index keyed map, func maps the old index to the new one
+template <class Map, class Func>
+auto renumber(Map& map, const Func func) -> void {
+    auto moved = Map();
+    moved.reserve(map.size());
+    for(auto& [index, value] : map) {
+        moved.emplace(func(index), std::move(value));
+    }
+    map = std::move(moved);
+}
+
+template <class Func>
+auto renumber(std::unordered_set<size_t>& set, const Func func) -> void {
+    auto moved = std::unordered_set<size_t>();
+    moved.reserve(set.size());
+    for(const auto index : set) {
+        moved.insert(func(index));
+    }
+    set = std::move(moved);
+}
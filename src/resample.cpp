@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+#include "resample.hpp"
+#include "simd/kernels.hpp"
+
+namespace {
+constexpr auto lanczos_lobes = 3.0;
+
+auto lanczos_kernel(const double x) -> double {
+    if(x == 0) {
+        return 1;
+    }
+    if(std::abs(x) >= lanczos_lobes) {
+        return 0;
+    }
+    const auto px = std::numbers::pi * x;
+    return lanczos_lobes * std::sin(px) * std::sin(px / lanczos_lobes) / (px * px);
+}
+
+// weights of one axis, windows near the edges are shifted inside and the weights outside the image zeroed
+auto make_filter(const size_t src_size, const size_t dst_size) -> simd::Filter {
+    const auto scale   = 1. * src_size / dst_size;
+    const auto stretch = std::max(1.0, scale); // widen the kernel when reducing
+    const auto support = lanczos_lobes * stretch;
+    const auto taps    = std::min(src_size, size_t(std::ceil(support * 2)) + 1);
+
+    auto filter = simd::Filter{taps, std::vector<size_t>(dst_size), std::vector<float>(dst_size * taps)};
+    for(auto x = 0uz; x < dst_size; x += 1) {
+        const auto center = (x + 0.5) * scale - 0.5;
+        const auto first  = size_t(std::max(0.0, std::ceil(center - support)));
+        const auto last   = size_t(std::clamp(std::floor(center + support), 0.0, src_size - 1.0));
+        const auto start  = std::min(first, src_size - taps);
+        const auto w      = filter.weights.data() + x * taps;
+        auto       sum    = 0.0;
+        for(auto k = 0uz; k < taps; k += 1) {
+            const auto i = start + k;
+            const auto v = i >= first && i <= last ? lanczos_kernel((i - center) / stretch) : 0.0;
+            w[k]         = float(v);
+            sum         += v;
+        }
+        for(auto k = 0uz; k < taps; k += 1) {
+            w[k] = float(w[k] / sum);
+        }
+        filter.starts[x] = start;
+    }
+    return filter;
+}
+} // namespace
+
+auto fit_size(const size_t width, const size_t height, const std::array<size_t, 2> box) -> std::array<size_t, 2> {
+    const auto factor = std::min(1. * box[0] / width, 1. * box[1] / height);
+    if(factor >= 1.0) {
+        return {width, height};
+    }
+    return {std::max(1uz, size_t(std::lround(width * factor))), std::max(1uz, size_t(std::lround(height * factor)))};
+}
+
+auto area_average(const std::byte* const src, const size_t src_width, const size_t src_height, const size_t dst_width, const size_t dst_height, const simd::Kernels& kernels) -> std::vector<std::byte> {
+
+    auto dst  = std::vector<std::byte>(dst_width * dst_height * 4);
+    auto sums = std::vector<uint32_t>(dst_width * 4);
+
+    // source column range of each destination column
+    auto columns = std::vector<size_t>(dst_width + 1);
+    for(auto x = 0uz; x <= dst_width; x += 1) {
+        columns[x] = x * src_width / dst_width;
+    }
+
+    for(auto y = 0uz; y < dst_height; y += 1) {
+        const auto row_begin = y * src_height / dst_height;
+        const auto row_end   = std::max(row_begin + 1, (y + 1) * src_height / dst_height);
+        std::fill(sums.begin(), sums.end(), 0);
+        for(auto sy = row_begin; sy < row_end; sy += 1) {
+            kernels.area_row(std::bit_cast<const uint8_t*>(src) + sy * src_width * 4, columns.data(), dst_width, sums.data());
+        }
+        const auto rows = row_end - row_begin;
+        const auto out  = std::bit_cast<uint8_t*>(dst.data()) + y * dst_width * 4;
+        for(auto x = 0uz; x < dst_width; x += 1) {
+            const auto count = uint32_t(std::max(columns[x] + 1, columns[x + 1]) - columns[x]) * uint32_t(rows);
+            for(auto c = 0; c < 4; c += 1) {
+                out[x * 4 + c] = uint8_t((sums[x * 4 + c] + count / 2) / count);
+            }
+        }
+    }
+    return dst;
+}
+
+auto lanczos(const std::byte* const src, const size_t src_width, const size_t src_height, const size_t dst_width, const size_t dst_height, const simd::Kernels& kernels) -> std::vector<std::byte> {
+    const auto horizontal = make_filter(src_width, dst_width);
+    const auto vertical   = make_filter(src_height, dst_height);
+    const auto stride     = dst_width * 4;
+
+    // horizontal pass into a ring of rows, each source row is filtered once when the vertical window first reaches it
+    const auto ring_size = vertical.taps;
+    auto       ring      = std::vector<float>(ring_size * stride);
+    auto       filtered  = 0uz; // source rows filtered so far
+    auto       rows      = std::vector<const float*>(vertical.taps);
+
+    auto dst = std::vector<std::byte>(dst_height * stride);
+    for(auto y = 0uz; y < dst_height; y += 1) {
+        const auto start = vertical.starts[y];
+        for(filtered = std::max(filtered, start); filtered < start + vertical.taps; filtered += 1) {
+            const auto row = std::bit_cast<const uint8_t*>(src) + filtered * src_width * 4;
+            kernels.filter_row(row, horizontal, ring.data() + filtered % ring_size * stride);
+        }
+        for(auto k = 0uz; k < vertical.taps; k += 1) {
+            rows[k] = ring.data() + (start + k) % ring_size * stride;
+        }
+        const auto out = std::bit_cast<uint8_t*>(dst.data()) + y * stride;
+        kernels.filter_column(rows.data(), vertical.weights.data() + y * vertical.taps, vertical.taps, stride, out);
+    }
+    return dst;
+}
+
+auto downscale(const std::byte* const src, const size_t src_width, const size_t src_height, const size_t dst_width, const size_t dst_height) -> std::vector<std::byte> {
+    if(src_width < dst_width * 2 && src_height < dst_height * 2) {
+        return lanczos(src, src_width, src_height, dst_width, dst_height);
+    }
+    return area_average(src, src_width, src_height, dst_width, dst_height);
+}
+
+auto expand_rgb(const std::byte* const src, std::byte* const dst, const size_t count, const simd::Kernels& kernels) -> void {
+    kernels.expand_rgb(std::bit_cast<const uint8_t*>(src), std::bit_cast<uint8_t*>(dst), count);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "simd/kernels.hpp"
+
+// size of an image fitted into box, never larger than the image itself
+auto fit_size(size_t width, size_t height, std::array<size_t, 2> box) -> std::array<size_t, 2>;
+
+// kernels default to the fastest set for the cpu, tests pass each set to compare them
+
+// downscales rgba pixels by averaging the source pixels covered by each destination pixel
+auto area_average(const std::byte* src, size_t src_width, size_t src_height, size_t dst_width, size_t dst_height, const simd::Kernels& kernels = simd::get_kernels()) -> std::vector<std::byte>;
+
+// resamples rgba pixels with a lanczos3 filter, sharper than area_average for small reductions
+auto lanczos(const std::byte* src, size_t src_width, size_t src_height, size_t dst_width, size_t dst_height, const simd::Kernels& kernels = simd::get_kernels()) -> std::vector<std::byte>;
+
+// picks lanczos for reductions below 2x and area_average otherwise
+auto downscale(const std::byte* src, size_t src_width, size_t src_height, size_t dst_width, size_t dst_height) -> std::vector<std::byte>;
+
+// rgb to rgba with opaque alpha, dst may be the head of a buffer whose tail holds src
+auto expand_rgb(const std::byte* src, std::byte* dst, size_t count, const simd::Kernels& kernels = simd::get_kernels()) -> void;
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <string_view>
+
+#include "../macros/assert.hpp"
+#include "kernels.hpp"
+
+namespace simd {
+namespace {
+auto detect() -> const Kernels& {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return avx2;
+    }
+    if(__builtin_cpu_supports("sse4.1")) {
+        return sse41;
+    }
+#endif
+#if defined(__ARM_NEON)
+    return neon;
+#endif
+    return scalar;
+}
+
+auto select() -> const Kernels& {
+    const auto& best = detect();
+    const auto  env  = std::getenv("IMGVIEW_SIMD");
+    if(env == nullptr) {
+        return best;
+    }
+    const auto name = std::string_view(env);
+    if(name == scalar.name) {
+        return scalar;
+    }
+    if(name == best.name) {
+        return best;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if(name == sse41.name && &best == &avx2) {
+        return sse41;
+    }
+#endif
+    line_warn("simd kernels {} are not available, using {}", name, best.name);
+    return best;
+}
+} // namespace
+
+auto get_available() -> std::vector<const Kernels*> {
+    auto ret = std::vector{&scalar};
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.1")) {
+        ret.push_back(&sse41);
+    }
+    if(__builtin_cpu_supports("avx2")) {
+        ret.push_back(&avx2);
+    }
+#endif
+#if defined(__ARM_NEON)
+    ret.push_back(&neon);
+#endif
+    return ret;
+}
+
+auto get_kernels() -> const Kernels& {
+    static const auto& kernels = select();
+    return kernels;
+}
+} // namespace simd
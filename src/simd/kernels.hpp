@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// pixel kernels with one implementation per instruction set, the best one for the cpu is picked at runtime
+// every implementation gives the same result as the scalar one
+namespace simd {
+// resampling weights of one axis, every destination pixel reads taps consecutive source pixels from its start
+struct Filter {
+    size_t              taps;
+    std::vector<size_t> starts;  // per destination pixel
+    std::vector<float>  weights; // taps per destination pixel, normalized
+};
+
+struct Kernels {
+    const char* name;
+    // adds the rgba source pixels [columns[x], max(columns[x] + 1, columns[x + 1])) of row into sums[x * 4 + c]
+    void (*area_row)(const uint8_t* row, const size_t* columns, size_t dst_width, uint32_t* sums);
+    // horizontal pass, writes filter.starts.size() rgba pixels as floats
+    void (*filter_row)(const uint8_t* row, const Filter& filter, float* out);
+    // vertical pass, out[i] = sum of weights[k] * rows[k][i], rounded and clamped
+    void (*filter_column)(const float* const* rows, const float* weights, size_t taps, size_t count, uint8_t* out);
+    // rgb to rgba with opaque alpha
+    // dst may overlap src as long as src starts at least count bytes after dst, as when expanding in place from the tail of a buffer
+    void (*expand_rgb)(const uint8_t* src, uint8_t* dst, size_t count);
+};
+
+extern const Kernels scalar;
+#if defined(__x86_64__) || defined(__i386__)
+extern const Kernels sse41;
+extern const Kernels avx2;
+#endif
+#if defined(__ARM_NEON)
+extern const Kernels neon;
+#endif
+
+// every kernel set this cpu can run, scalar first
+auto get_available() -> std::vector<const Kernels*>;
+// the fastest kernels supported by this cpu
+// IMGVIEW_SIMD=scalar|sse41|avx2|neon overrides the choice, for comparisons
+auto get_kernels() -> const Kernels&;
+} // namespace simd
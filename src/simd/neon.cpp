@@ -0,0 +1,86 @@
+#if defined(__ARM_NEON)
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <arm_neon.h>
+
+#include "kernels.hpp"
+
+// multiplies and adds are kept separate instead of vmlaq/vfmaq to match the scalar results
+namespace simd {
+namespace {
+auto load_pixel(const uint8_t* const ptr) -> uint32x4_t {
+    auto value = uint32_t();
+    std::memcpy(&value, ptr, 4);
+    return vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(value))));
+}
+
+auto round_clamp(const float value) -> uint8_t {
+    return uint8_t(std::clamp(std::nearbyint(value), 0.0f, 255.0f));
+}
+
+auto area_row(const uint8_t* const row, const size_t* const columns, const size_t dst_width, uint32_t* const sums) -> void {
+    for(auto x = 0uz; x < dst_width; x += 1) {
+        const auto end = std::max(columns[x] + 1, columns[x + 1]);
+        auto       acc = vld1q_u32(sums + x * 4);
+        for(auto sx = columns[x]; sx < end; sx += 1) {
+            acc = vaddq_u32(acc, load_pixel(row + sx * 4));
+        }
+        vst1q_u32(sums + x * 4, acc);
+    }
+}
+
+auto filter_row(const uint8_t* const row, const Filter& filter, float* const out) -> void {
+    for(auto x = 0uz; x < filter.starts.size(); x += 1) {
+        const auto src     = row + filter.starts[x] * 4;
+        const auto weights = filter.weights.data() + x * filter.taps;
+        auto       acc     = vdupq_n_f32(0);
+        for(auto k = 0uz; k < filter.taps; k += 1) {
+            acc = vaddq_f32(acc, vmulq_n_f32(vcvtq_f32_u32(load_pixel(src + k * 4)), weights[k]));
+        }
+        vst1q_f32(out + x * 4, acc);
+    }
+}
+
+auto filter_column(const float* const* const rows, const float* const weights, const size_t taps, const size_t count, uint8_t* const out) -> void {
+    auto i = 0uz;
+    for(; i + 8 <= count; i += 8) {
+        auto lo = vdupq_n_f32(0);
+        auto hi = vdupq_n_f32(0);
+        for(auto k = 0uz; k < taps; k += 1) {
+            lo = vaddq_f32(lo, vmulq_n_f32(vld1q_f32(rows[k] + i), weights[k]));
+            hi = vaddq_f32(hi, vmulq_n_f32(vld1q_f32(rows[k] + i + 4), weights[k]));
+        }
+        // vcvtnq rounds half to even, the narrowing moves saturate
+        const auto words = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)), vqmovn_s32(vcvtnq_s32_f32(hi)));
+        vst1_u8(out + i, vqmovun_s16(words));
+    }
+    for(; i < count; i += 1) {
+        auto acc = 0.0f;
+        for(auto k = 0uz; k < taps; k += 1) {
+            acc += weights[k] * rows[k][i];
+        }
+        out[i] = round_clamp(acc);
+    }
+}
+
+auto expand_rgb(const uint8_t* const src, uint8_t* const dst, const size_t count) -> void {
+    auto i = 0uz;
+    for(; i + 8 <= count; i += 8) {
+        const auto rgb  = vld3_u8(src + i * 3);
+        auto       rgba = uint8x8x4_t{{rgb.val[0], rgb.val[1], rgb.val[2], vdup_n_u8(0xff)}};
+        vst4_u8(dst + i * 4, rgba);
+    }
+    for(; i < count; i += 1) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 0xff;
+    }
+}
+} // namespace
+
+const Kernels neon = {"neon", area_row, filter_row, filter_column, expand_rgb};
+} // namespace simd
+#endif
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "kernels.hpp"
+
+namespace simd {
+namespace {
+auto area_row(const uint8_t* const row, const size_t* const columns, const size_t dst_width, uint32_t* const sums) -> void {
+    for(auto x = 0uz; x < dst_width; x += 1) {
+        const auto end = std::max(columns[x] + 1, columns[x + 1]);
+        for(auto sx = columns[x]; sx < end; sx += 1) {
+            for(auto c = 0; c < 4; c += 1) {
+                sums[x * 4 + c] += row[sx * 4 + c];
+            }
+        }
+    }
+}
+
+auto filter_row(const uint8_t* const row, const Filter& filter, float* const out) -> void {
+    for(auto x = 0uz; x < filter.starts.size(); x += 1) {
+        const auto src     = row + filter.starts[x] * 4;
+        const auto weights = filter.weights.data() + x * filter.taps;
+        auto       acc     = std::array{0.0f, 0.0f, 0.0f, 0.0f};
+        for(auto k = 0uz; k < filter.taps; k += 1) {
+            for(auto c = 0; c < 4; c += 1) {
+                acc[c] += weights[k] * float(src[k * 4 + c]);
+            }
+        }
+        std::copy(acc.begin(), acc.end(), out + x * 4);
+    }
+}
+
+auto filter_column(const float* const* const rows, const float* const weights, const size_t taps, const size_t count, uint8_t* const out) -> void {
+    for(auto i = 0uz; i < count; i += 1) {
+        auto acc = 0.0f;
+        for(auto k = 0uz; k < taps; k += 1) {
+            acc += weights[k] * rows[k][i];
+        }
+        // round half to even, like the vector conversions
+        out[i] = uint8_t(std::clamp(std::nearbyint(acc), 0.0f, 255.0f));
+    }
+}
+
+auto expand_rgb(const uint8_t* const src, uint8_t* const dst, const size_t count) -> void {
+    for(auto i = 0uz; i < count; i += 1) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 0xff;
+    }
+}
+} // namespace
+
+const Kernels scalar = {"scalar", area_row, filter_row, filter_column, expand_rgb};
+} // namespace simd
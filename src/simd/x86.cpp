@@ -0,0 +1,178 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "kernels.hpp"
+
+// every function carries its own target so that the rest of the program stays baseline x86
+// fma is not enabled, multiplies and adds stay separate to match the scalar results
+namespace simd {
+namespace {
+[[gnu::target("sse4.1")]] auto load_pixel(const uint8_t* const ptr) -> __m128i {
+    auto value = uint32_t();
+    std::memcpy(&value, ptr, 4);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(int(value)));
+}
+
+[[gnu::target("sse4.1")]] auto pack_pixels(const __m128 lo, const __m128 hi) -> __m128i {
+    // rounds half to even, packus clamps to [0, 255]
+    const auto words = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+    return _mm_packus_epi16(words, words);
+}
+
+auto round_clamp(const float value) -> uint8_t {
+    return uint8_t(std::clamp(std::nearbyint(value), 0.0f, 255.0f));
+}
+
+// sse4.1
+[[gnu::target("sse4.1")]] auto area_row_sse41(const uint8_t* const row, const size_t* const columns, const size_t dst_width, uint32_t* const sums) -> void {
+    for(auto x = 0uz; x < dst_width; x += 1) {
+        const auto ptr = std::bit_cast<__m128i*>(sums + x * 4);
+        const auto end = std::max(columns[x] + 1, columns[x + 1]);
+        auto       acc = _mm_loadu_si128(ptr);
+        for(auto sx = columns[x]; sx < end; sx += 1) {
+            acc = _mm_add_epi32(acc, load_pixel(row + sx * 4));
+        }
+        _mm_storeu_si128(ptr, acc);
+    }
+}
+
+[[gnu::target("sse4.1")]] auto filter_row_sse41(const uint8_t* const row, const Filter& filter, float* const out) -> void {
+    for(auto x = 0uz; x < filter.starts.size(); x += 1) {
+        const auto src     = row + filter.starts[x] * 4;
+        const auto weights = filter.weights.data() + x * filter.taps;
+        auto       acc     = _mm_setzero_ps();
+        for(auto k = 0uz; k < filter.taps; k += 1) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_cvtepi32_ps(load_pixel(src + k * 4))));
+        }
+        _mm_storeu_ps(out + x * 4, acc);
+    }
+}
+
+[[gnu::target("sse4.1")]] auto filter_column_sse41(const float* const* const rows, const float* const weights, const size_t taps, const size_t count, uint8_t* const out) -> void {
+    auto i = 0uz;
+    for(; i + 8 <= count; i += 8) {
+        auto lo = _mm_setzero_ps();
+        auto hi = _mm_setzero_ps();
+        for(auto k = 0uz; k < taps; k += 1) {
+            const auto w = _mm_set1_ps(weights[k]);
+            lo           = _mm_add_ps(lo, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + i)));
+            hi           = _mm_add_ps(hi, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + i + 4)));
+        }
+        _mm_storel_epi64(std::bit_cast<__m128i*>(out + i), pack_pixels(lo, hi));
+    }
+    for(; i < count; i += 1) {
+        auto acc = 0.0f;
+        for(auto k = 0uz; k < taps; k += 1) {
+            acc += weights[k] * rows[k][i];
+        }
+        out[i] = round_clamp(acc);
+    }
+}
+
+[[gnu::target("sse4.1")]] auto expand_rgb_sse41(const uint8_t* const src, uint8_t* const dst, const size_t count) -> void {
+    const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const auto alpha   = _mm_set1_epi32(int(0xff000000));
+    auto       i       = 0uz;
+    // 16 bytes are loaded for every 4 pixels, stop while the whole load is inside src
+    // with src count bytes after dst, the store never reaches pixels not loaded yet
+    for(; i + 6 <= count; i += 4) {
+        const auto rgb = _mm_loadu_si128(std::bit_cast<const __m128i*>(src + i * 3));
+        _mm_storeu_si128(std::bit_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+    for(; i < count; i += 1) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 0xff;
+    }
+}
+
+// avx2
+[[gnu::target("avx2")]] auto area_row_avx2(const uint8_t* const row, const size_t* const columns, const size_t dst_width, uint32_t* const sums) -> void {
+    for(auto x = 0uz; x < dst_width; x += 1) {
+        const auto ptr  = std::bit_cast<__m128i*>(sums + x * 4);
+        const auto end  = std::max(columns[x] + 1, columns[x + 1]);
+        auto       sx   = columns[x];
+        auto       acc2 = _mm256_setzero_si256(); // two pixels per step
+        for(; sx + 2 <= end; sx += 2) {
+            acc2 = _mm256_add_epi32(acc2, _mm256_cvtepu8_epi32(_mm_loadl_epi64(std::bit_cast<const __m128i*>(row + sx * 4))));
+        }
+        auto acc = _mm_add_epi32(_mm_loadu_si128(ptr), _mm_add_epi32(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1)));
+        if(sx < end) {
+            auto value = uint32_t();
+            std::memcpy(&value, row + sx * 4, 4);
+            acc = _mm_add_epi32(acc, _mm_cvtepu8_epi32(_mm_cvtsi32_si128(int(value))));
+        }
+        _mm_storeu_si128(ptr, acc);
+    }
+}
+
+[[gnu::target("avx2")]] auto filter_row_avx2(const uint8_t* const row, const Filter& filter, float* const out) -> void {
+    // two destination pixels per register, each lane keeps the scalar summation order
+    const auto width = filter.starts.size();
+    auto       x     = 0uz;
+    for(; x + 2 <= width; x += 2) {
+        const auto src0 = row + filter.starts[x] * 4;
+        const auto src1 = row + filter.starts[x + 1] * 4;
+        const auto w0   = filter.weights.data() + x * filter.taps;
+        const auto w1   = w0 + filter.taps;
+        auto       acc  = _mm256_setzero_ps();
+        for(auto k = 0uz; k < filter.taps; k += 1) {
+            auto p0 = uint32_t(), p1 = uint32_t();
+            std::memcpy(&p0, src0 + k * 4, 4);
+            std::memcpy(&p1, src1 + k * 4, 4);
+            const auto pixels = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_setr_epi32(int(p0), int(p1), 0, 0)));
+            const auto w      = _mm256_set_m128(_mm_set1_ps(w1[k]), _mm_set1_ps(w0[k]));
+            acc               = _mm256_add_ps(acc, _mm256_mul_ps(w, pixels));
+        }
+        _mm256_storeu_ps(out + x * 4, acc);
+    }
+    if(x < width) {
+        const auto src     = row + filter.starts[x] * 4;
+        const auto weights = filter.weights.data() + x * filter.taps;
+        auto       acc     = _mm_setzero_ps();
+        for(auto k = 0uz; k < filter.taps; k += 1) {
+            auto value = uint32_t();
+            std::memcpy(&value, src + k * 4, 4);
+            const auto pixel = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(int(value))));
+            acc              = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), pixel));
+        }
+        _mm_storeu_ps(out + x * 4, acc);
+    }
+}
+
+[[gnu::target("avx2")]] auto filter_column_avx2(const float* const* const rows, const float* const weights, const size_t taps, const size_t count, uint8_t* const out) -> void {
+    auto i = 0uz;
+    for(; i + 16 <= count; i += 16) {
+        auto lo = _mm256_setzero_ps();
+        auto hi = _mm256_setzero_ps();
+        for(auto k = 0uz; k < taps; k += 1) {
+            const auto w = _mm256_set1_ps(weights[k]);
+            lo           = _mm256_add_ps(lo, _mm256_mul_ps(w, _mm256_loadu_ps(rows[k] + i)));
+            hi           = _mm256_add_ps(hi, _mm256_mul_ps(w, _mm256_loadu_ps(rows[k] + i + 8)));
+        }
+        // packs work within 128 bit lanes, gather the four useful dwords back into order
+        const auto words = _mm256_packs_epi32(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi));
+        const auto bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words, words), _mm256_setr_epi32(0, 4, 1, 5, 0, 0, 0, 0));
+        _mm_storeu_si128(std::bit_cast<__m128i*>(out + i), _mm256_castsi256_si128(bytes));
+    }
+    for(; i < count; i += 1) {
+        auto acc = 0.0f;
+        for(auto k = 0uz; k < taps; k += 1) {
+            acc += weights[k] * rows[k][i];
+        }
+        out[i] = round_clamp(acc);
+    }
+}
+} // namespace
+
+const Kernels sse41 = {"sse41", area_row_sse41, filter_row_sse41, filter_column_sse41, expand_rgb_sse41};
+// expansion is bound by memory bandwidth, wider registers do not help
+const Kernels avx2 = {"avx2", area_row_avx2, filter_row_avx2, filter_column_avx2, expand_rgb_sse41};
+} // namespace simd
+#endif
@@ -1,62 +1,64 @@
 #include <algorithm>
+#include <compare>
+#include <cstdint>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
-auto sort_strings(std::vector<std::string>& strings) -> void {
-    auto swap_flag = std::unordered_set<size_t>();
-    auto max_len   = 0uz;
-    for(auto& s : strings) {
-        if(auto len = s.size(); len > max_len) {
-            max_len = len;
-        }
+#include "sort.hpp"
+
+namespace {
+// ascii letters are compared case-insensitively and bytes are ordered as signed chars,
+// flip the sign bit so that plain unsigned comparison of the keys gives the same order
+auto to_key(const char c) -> char {
+    const auto folded = (c >= 'A' && c <= 'Z') ? char(c + 32) : c;
+    return char(static_cast<unsigned char>(folded) ^ 0x80);
+}
+
+struct SortItem {
+    std::string_view key;
+    size_t           index;
+};
+} // namespace
+
+auto sort_strings(NameList& names) -> void {
+    auto total = 0uz;
+    for(const auto name : names) {
+        total += name.size();
     }
-    for(auto i = 0uz; i < max_len; i += 1) {
-        const auto k = max_len - i;
-
-        auto sort_count = 0uz;
-        for(auto j = 0uz; j < strings.size(); j += 1) {
-            if(strings[j].size() >= k) {
-                swap_flag.emplace(j);
-                sort_count += 1;
-            }
-        }
-        auto sep = strings.size() - sort_count;
-        for(auto j = 0uz, swapped = 0uz; j < strings.size(); j += 1) {
-            if(swap_flag.contains(j) && j < sep) {
-                if(!swap_flag.contains(sep + swapped)) {
-                    std::iter_swap(strings.begin() + j, strings.begin() + sep + swapped);
-                } else {
-                    while(swap_flag.contains(sep + swapped)) {
-                        swapped += 1;
-                        if(sep + swapped >= strings.size()) {
-                            break;
-                        } else {
-                            std::iter_swap(strings.begin() + j, strings.begin() + sep + swapped);
-                        }
-                    }
-                }
-                swap_flag.erase(j);
-                swap_flag.erase(sep + swapped);
-                swapped += 1;
-            }
-        }
 
-        auto copy_buffer    = std::vector<std::string>(sort_count);
-        auto char_and_index = std::vector<std::pair<char, size_t>>(sort_count);
-
-        for(auto j = 0uz; j < sort_count; j += 1) {
-            copy_buffer[j] = std::move(strings[sep + j]);
-            if(auto c = copy_buffer[j][k - 1]; c >= 65 && c <= 90) {
-                char_and_index[j].first = c + 32;
-            } else {
-                char_and_index[j].first = c;
-            }
-            char_and_index[j].second = j;
-        }
-        std::stable_sort(char_and_index.begin(), char_and_index.end());
-        for(auto j = 0uz; j < sort_count; j += 1) {
-            strings[sep + j] = std::move(copy_buffer[char_and_index[j].second]);
+    // build all keys into a single buffer
+    auto keys = std::string(total, '\0');
+    auto sort = std::vector<SortItem>(names.size());
+    for(auto i = 0uz, offset = 0uz; i < names.size(); i += 1) {
+        const auto s = names[i];
+        std::transform(s.begin(), s.end(), keys.begin() + offset, to_key);
+        sort[i]  = SortItem{std::string_view(keys).substr(offset, s.size()), i};
+        offset  += s.size();
+    }
+
+    std::sort(sort.begin(), sort.end(), [&names](const SortItem& a, const SortItem& b) {
+        if(const auto r = a.key.compare(b.key); r != 0) {
+            return r < 0;
         }
+        // names which differ only in case
+        return names[a.index] < names[b.index];
+    });
+
+    auto order = std::vector<size_t>(sort.size());
+    for(auto i = 0uz; i < sort.size(); i += 1) {
+        order[i] = sort[i].index;
+    }
+    names.reorder(order);
+}
+
+auto compare_strings(const std::string_view a, const std::string_view b) -> bool {
+    // keys compare as unsigned chars, like string_view::compare does in sort_strings
+    const auto r = std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), [](const char x, const char y) {
+        return uint8_t(to_key(x)) <=> uint8_t(to_key(y));
+    });
+    if(r != 0) {
+        return r < 0;
     }
+    return a < b;
 }
@@ -1,5 +1,8 @@
 #pragma once
-#include <string>
-#include <vector>
+#include <string_view>
 
-auto sort_strings(std::vector<std::string>& strings) -> void;
+#include "name-list.hpp"
+
+auto sort_strings(NameList& names) -> void;
+// the order of sort_strings, for keeping sorted lists sorted
+auto compare_strings(std::string_view a, std::string_view b) -> bool;
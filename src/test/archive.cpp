@@ -0,0 +1,116 @@
+#include <fstream>
+#include <print>
+
+#include <unistd.h>
+
+#include "../archive.hpp"
+
+// a crafted central directory must be rejected, never read past its record
+namespace {
+auto put_u16(std::vector<std::byte>& buf, const size_t value) -> void {
+    buf.push_back(std::byte(value));
+    buf.push_back(std::byte(value >> 8));
+}
+
+auto put_u32(std::vector<std::byte>& buf, const size_t value) -> void {
+    put_u16(buf, value & 0xffff);
+    put_u16(buf, value >> 16);
+}
+
+auto put_u64(std::vector<std::byte>& buf, const size_t value) -> void {
+    put_u32(buf, value & 0xffffffff);
+    put_u32(buf, value >> 32);
+}
+
+auto put_str(std::vector<std::byte>& buf, const std::string_view str) -> void {
+    for(const auto c : str) {
+        buf.push_back(std::byte(c));
+    }
+}
+
+// one stored member, sizes moved to a zip64 extra field
+// field_len is the length the field declares, extra_len the length of the extra region the record declares
+auto make_zip(const std::string_view name, const std::string_view body, const size_t field_len, const size_t extra_len) -> std::vector<std::byte> {
+    auto zip = std::vector<std::byte>();
+    // local header
+    put_u32(zip, 0x04034b50);
+    put_u16(zip, 45);          // version
+    put_u16(zip, 0);           // flags
+    put_u16(zip, 0);           // method
+    put_u32(zip, 0);           // time, date
+    put_u32(zip, 0);           // crc
+    put_u32(zip, body.size()); // compressed
+    put_u32(zip, body.size()); // size
+    put_u16(zip, name.size());
+    put_u16(zip, 0); // extra
+    put_str(zip, name);
+    put_str(zip, body);
+
+    // central directory
+    const auto cd_offset = zip.size();
+    put_u32(zip, 0x02014b50);
+    put_u16(zip, 45); // made by
+    put_u16(zip, 45); // version
+    put_u16(zip, 0);  // flags
+    put_u16(zip, 0);  // method
+    put_u32(zip, 0);  // time, date
+    put_u32(zip, 0);  // crc
+    put_u32(zip, 0xffffffff);
+    put_u32(zip, 0xffffffff);
+    put_u16(zip, name.size());
+    put_u16(zip, extra_len);
+    put_u16(zip, 0); // comment
+    put_u16(zip, 0); // disk
+    put_u16(zip, 0); // internal attributes
+    put_u32(zip, 0); // external attributes
+    put_u32(zip, 0); // local header
+    put_str(zip, name);
+    auto extra = std::vector<std::byte>();
+    put_u16(extra, 0x0001);
+    put_u16(extra, field_len);
+    put_u64(extra, body.size());
+    put_u64(extra, body.size());
+    extra.resize(extra_len);
+    zip.insert(zip.end(), extra.begin(), extra.end());
+    const auto cd_size = zip.size() - cd_offset;
+
+    // end of central directory
+    put_u32(zip, 0x06054b50);
+    put_u16(zip, 0); // disk
+    put_u16(zip, 0); // cd disk
+    put_u16(zip, 1);
+    put_u16(zip, 1);
+    put_u32(zip, cd_size);
+    put_u32(zip, cd_offset);
+    put_u16(zip, 0); // comment
+    return zip;
+}
+
+auto open_zip(const std::vector<std::byte>& zip) -> std::shared_ptr<Archive> {
+    const auto path = std::filesystem::temp_directory_path() / std::format("imgview-archive-test-{}.zip", getpid());
+    std::ofstream(path, std::ios::binary).write(std::bit_cast<const char*>(zip.data()), std::streamsize(zip.size()));
+    auto archive = Archive::open(path);
+    std::filesystem::remove(path);
+    return archive;
+}
+
+auto test(const char* const label, const size_t field_len, const size_t extra_len, const bool valid) -> bool {
+    const auto archive = open_zip(make_zip("a.jpg", "body", field_len, extra_len));
+    const auto data    = archive ? archive->read("a.jpg") : std::nullopt;
+    const auto read    = data && std::string_view(std::bit_cast<const char*>(data->bytes.data()), data->bytes.size()) == "body";
+    if(read != valid) {
+        std::println("{}: {}", label, valid ? "rejected" : "accepted");
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+auto main() -> int {
+    auto ok = true;
+    ok &= test("zip64 field", 16, 20, true);
+    ok &= test("zip64 field longer than the extra region", 16, 12, false);
+    ok &= test("zip64 field of maximum length", 0xffff, 20, false);
+    ok &= test("extra region shorter than a field header", 16, 2, false);
+    return ok ? 0 : 1;
+}
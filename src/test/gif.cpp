@@ -0,0 +1,167 @@
+#include <print>
+
+#include "../codec/animation.hpp"
+
+// composition, frame durations and size limits of the gif decoder
+// expected pixels are what pillow composes for the same files, except where noted
+namespace {
+constexpr auto n = std::array<uint8_t, 4>{0, 0, 0, 0};     // transparent
+constexpr auto r = std::array<uint8_t, 4>{255, 0, 0, 255}; // red
+constexpr auto g = std::array<uint8_t, 4>{0, 255, 0, 255}; // green
+constexpr auto b = std::array<uint8_t, 4>{0, 0, 255, 255}; // blue
+constexpr auto k = std::array<uint8_t, 4>{0, 0, 0, 255};   // black
+
+struct GIFFrame {
+    size_t               x;
+    size_t               y;
+    size_t               width;
+    size_t               height;
+    std::vector<uint8_t> indices;
+    uint8_t              disposal;
+    int                  delay;            // 10ms units
+    int                  transparent = -1; // color index
+};
+
+auto put_u16(std::vector<std::byte>& buf, const size_t value) -> void {
+    buf.push_back(std::byte(value));
+    buf.push_back(std::byte(value >> 8));
+}
+
+// 2bit indices, a clear code before every pixel keeps the codes 3bit wide
+auto put_lzw(std::vector<std::byte>& buf, const std::vector<uint8_t>& indices) -> void {
+    auto codes = std::vector<std::byte>();
+    auto bits  = 0u;
+    auto count = 0;
+    auto put   = [&](const uint8_t code) {
+        bits  |= code << count;
+        count += 3;
+        for(; count >= 8; count -= 8, bits >>= 8) {
+            codes.push_back(std::byte(bits));
+        }
+    };
+    for(const auto index : indices) {
+        put(4);
+        put(index);
+    }
+    put(5);
+    if(count > 0) {
+        codes.push_back(std::byte(bits));
+    }
+    buf.push_back(std::byte(2));
+    for(auto i = 0uz; i < codes.size(); i += 255) {
+        const auto len = std::min(codes.size() - i, 255uz);
+        buf.push_back(std::byte(len));
+        buf.insert(buf.end(), codes.begin() + i, codes.begin() + i + len);
+    }
+    buf.push_back(std::byte(0));
+}
+
+// global palette of black, red, green, blue
+auto make_gif(const size_t width, const size_t height, const std::vector<GIFFrame>& frames) -> std::vector<std::byte> {
+    auto gif = std::vector<std::byte>();
+    for(const auto c : std::string_view("GIF89a")) {
+        gif.push_back(std::byte(c));
+    }
+    put_u16(gif, width);
+    put_u16(gif, height);
+    for(const auto v : {0x81, 0, 0, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255}) {
+        gif.push_back(std::byte(v));
+    }
+    for(const auto& frame : frames) {
+        // graphic control
+        for(const auto v : {0x21, 0xf9, 4, frame.disposal << 2 | (frame.transparent >= 0 ? 1 : 0)}) {
+            gif.push_back(std::byte(v));
+        }
+        put_u16(gif, size_t(frame.delay));
+        gif.push_back(std::byte(std::max(frame.transparent, 0)));
+        gif.push_back(std::byte(0));
+        // image descriptor
+        gif.push_back(std::byte(0x2c));
+        for(const auto v : {frame.x, frame.y, frame.width, frame.height}) {
+            put_u16(gif, v);
+        }
+        gif.push_back(std::byte(0));
+        put_lzw(gif, frame.indices);
+    }
+    gif.push_back(std::byte(0x3b));
+    return gif;
+}
+
+struct Expected {
+    std::vector<std::array<uint8_t, 4>> pixels;
+    int                                 duration;
+};
+
+auto test(const char* const label, const std::vector<std::byte>& gif, const std::vector<Expected>& expected) -> bool {
+    auto bytes   = std::make_shared<std::vector<std::byte>>(gif);
+    auto decoder = open_gif(FileData{bytes, *bytes});
+    if(!decoder) {
+        std::println("{}: not decoded", label);
+        return false;
+    }
+    // twice, to cover the wrap around to the first frame
+    for(auto i = 0uz; i < expected.size() * 2; i += 1) {
+        const auto& exp   = expected[i % expected.size()];
+        const auto  frame = decoder->next();
+        if(!frame) {
+            std::println("{}: frame {} not decoded", label, i);
+            return false;
+        }
+        if(frame->duration.count() != exp.duration) {
+            std::println("{}: frame {} lasts {}ms, expected {}ms", label, i, frame->duration.count(), exp.duration);
+            return false;
+        }
+        for(auto p = 0uz; p < exp.pixels.size(); p += 1) {
+            auto pixel = std::array<uint8_t, 4>();
+            for(auto c = 0uz; c < 4; c += 1) {
+                pixel[c] = uint8_t(frame->pixels[p * 4 + c]);
+            }
+            if(pixel != exp.pixels[p]) {
+                std::println("{}: frame {} pixel {} differs", label, i, p);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+auto test_rejected(const char* const label, const std::vector<std::byte>& gif) -> bool {
+    auto bytes   = std::make_shared<std::vector<std::byte>>(gif);
+    auto decoder = open_gif(FileData{bytes, *bytes});
+    if(decoder && decoder->next()) {
+        std::println("{}: accepted", label);
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+auto main() -> int {
+    auto ok = true;
+    // a frame is restored to the canvas before it, durations of 10ms or less play as 100ms
+    // pillow reports the raw durations, the clamp follows browsers
+    ok &= test("disposal previous",
+               make_gif(3, 2, {{0, 0, 3, 2, {1, 1, 1, 1, 1, 1}, 1, 0}, {1, 0, 2, 1, {2, 2}, 3, 1}, {0, 1, 1, 1, {3}, 1, 2}}),
+               {{{r, r, r, r, r, r}, 100}, {{r, g, g, r, r, r}, 100}, {{r, r, r, b, r, r}, 20}});
+    // transparent pixels keep the canvas
+    ok &= test("transparency",
+               make_gif(2, 1, {{0, 0, 2, 1, {1, 1}, 1, 0}, {0, 0, 2, 1, {3, 0}, 1, 0, 0}}),
+               {{{r, r}, 100}, {{b, r}, 100}});
+    // the disposed frame has a transparent index, pillow clears to it as well
+    ok &= test("disposal background, transparent",
+               make_gif(3, 2, {{0, 0, 3, 2, {1, 1, 1, 1, 1, 1}, 2, 0, 3}, {1, 0, 1, 1, {2}, 0, 5}}),
+               {{{r, r, r, r, r, r}, 100}, {{n, g, n, n, n, n}, 50}});
+    // pillow fills with the opaque background color here, browsers and imgview clear to transparent
+    ok &= test("disposal background",
+               make_gif(3, 2, {{0, 0, 3, 2, {1, 1, 1, 1, 1, 1}, 2, 0}, {1, 0, 1, 1, {2}, 0, 5}}),
+               {{{r, r, r, r, r, r}, 100}, {{n, g, n, n, n, n}, 50}});
+    // a frame partly outside the canvas is clipped as browsers do, pillow grows the canvas instead
+    ok &= test("clipped frame",
+               make_gif(2, 2, {{0, 0, 2, 2, {0, 0, 0, 0}, 1, 10}, {1, 1, 2, 2, {2, 3, 3, 3}, 1, 10}}),
+               {{{k, k, k, k}, 100}, {{k, k, k, g}, 100}});
+
+    // sizes are checked before anything is allocated
+    ok &= test_rejected("huge canvas", make_gif(65535, 65535, {{0, 0, 1, 1, {1}, 1, 10}, {0, 0, 1, 1, {2}, 1, 10}}));
+    ok &= test_rejected("huge frame", make_gif(2, 2, {{0, 0, 65535, 65535, {1}, 1, 10}, {0, 0, 1, 1, {2}, 1, 10}}));
+    return ok ? 0 : 1;
+}
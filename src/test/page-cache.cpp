@@ -0,0 +1,205 @@
+#include <print>
+
+#include "../page-cache.hpp"
+
+// next_missing and within_budget must agree on which pages fit the budget
+// otherwise the scheduler claims pages the prioritizer drops, and claims them again forever
+namespace {
+constexpr auto mib = 1024uz * 1024;
+
+struct FakePage : Displayable {
+    size_t size;
+
+    auto decode(const FileData& /*data*/) -> bool override {
+        return true;
+    }
+
+    auto get_size() const -> size_t override {
+        return size;
+    }
+
+    auto draw(gawl::Screen* /*screen*/, const DrawParameters& /*params*/) -> void override {}
+
+    FakePage(const size_t size)
+        : size(size) {}
+};
+
+auto loaded_page(const size_t size) -> std::shared_ptr<Displayable> {
+    auto page   = std::shared_ptr<Displayable>(new FakePage(size));
+    page->state = Displayable::State::Loaded;
+    return page;
+}
+
+auto test(PageCache cache, const size_t center, const size_t count, const size_t keep_range, const size_t budget) -> bool {
+    auto within = std::vector<bool>(count);
+    auto cached = std::vector<bool>(count);
+    for(auto i = 0uz; i < count; i += 1) {
+        within[i] = cache.within_budget(i, center, count, keep_range, budget);
+        cached[i] = cache.contains(i);
+    }
+    // readahead covers what the budget does not, in both directions
+    for(const auto reverse : {false, true}) {
+        auto expected = std::vector<size_t>();
+        for(auto i = center; reverse ? i > 0 : i + 1 < count;) {
+            i += reverse ? -1 : 1;
+            if(!cache.contains(i) && !within[i]) {
+                expected.push_back(i);
+            }
+        }
+        const auto first = std::vector(expected.begin(), expected.begin() + std::min(expected.size(), 2uz));
+        if(cache.beyond_budget(center, reverse, count, count, keep_range, budget) != expected || cache.beyond_budget(center, reverse, 2, count, keep_range, budget) != first) {
+            std::println("center {} count {} budget {}MiB: wrong readahead pages", center, count, budget / mib);
+            return false;
+        }
+    }
+    // claim until nothing is missing, every claimed page must be kept by within_budget
+    auto claimed = std::vector<bool>(count);
+    while(const auto i = cache.next_missing(center, count, keep_range, budget)) {
+        if(!within[*i]) {
+            std::println("center {} count {} budget {}MiB: page {} claimed but not within budget", center, count, budget / mib, *i);
+            return false;
+        }
+        claimed[*i] = true;
+        cache.set(*i, std::shared_ptr<Displayable>(new FakePage(0)));
+    }
+    for(auto i = 0uz; i < count; i += 1) {
+        if(within[i] && !cached[i] && !claimed[i]) {
+            std::println("center {} count {} budget {}MiB: page {} within budget but never claimed", center, count, budget / mib, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// next_claim puts the pages on screen first, and priority must keep every page next_claim picks
+auto test_claim(PageCache cache, const size_t center, const size_t pages, const size_t count, const size_t keep_range, const size_t budget) -> bool {
+    const auto on_screen = [&](const size_t i) { return i >= center && i < center + pages; };
+
+    auto claimed = std::vector<size_t>();
+    while(const auto i = cache.next_claim(center, pages, count, keep_range, budget)) {
+        if(cache.contains(*i)) {
+            std::println("center {} pages {} budget {}MiB: page {} claimed twice", center, pages, budget / mib, *i);
+            return false;
+        }
+        if(!on_screen(*i)) {
+            for(auto j = center; j < std::min(center + pages, count); j += 1) {
+                if(!cache.contains(j)) {
+                    std::println("center {} pages {} budget {}MiB: page {} claimed before page {} on screen", center, pages, budget / mib, *i, j);
+                    return false;
+                }
+            }
+        }
+        claimed.push_back(*i);
+        cache.set(*i, std::shared_ptr<Displayable>(new FakePage(0)));
+    }
+    // checked once everything is claimed, later claims must not turn earlier ones stale
+    for(const auto i : claimed) {
+        const auto prio = cache.priority(i, center, pages, count, keep_range, budget);
+        if(!prio) {
+            std::println("center {} pages {} budget {}MiB: page {} claimed but stale", center, pages, budget / mib, i);
+            return false;
+        }
+        if((*prio == 0) != on_screen(i)) {
+            std::println("center {} pages {} budget {}MiB: page {} has priority {}", center, pages, budget / mib, i, *prio);
+            return false;
+        }
+    }
+    // and the pages it would not claim are stale
+    for(auto i = 0uz; i < count; i += 1) {
+        if(!cache.contains(i) && cache.priority(i, center, pages, count, keep_range, budget)) {
+            std::println("center {} pages {} budget {}MiB: page {} never claimed but has a priority", center, pages, budget / mib, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// insert_slot and remove_slot move pages along with their file
+// loading pages after the slot are dropped, their jobs refer to the old index
+auto test_slot(const bool insert, const size_t slot) -> bool {
+    constexpr auto count = 10uz;
+
+    auto cache = PageCache();
+    auto pages = std::vector<std::shared_ptr<Displayable>>(count);
+    for(const auto i : {2uz, 5uz}) {
+        pages[i] = loaded_page((i + 1) * mib);
+        cache.set(i, pages[i]);
+    }
+    for(const auto i : {3uz, 7uz}) {
+        pages[i] = std::shared_ptr<Displayable>(new FakePage(0));
+        cache.set(i, pages[i]);
+    }
+    auto used = cache.get_used();
+    if(insert) {
+        cache.insert_slot(slot);
+    } else {
+        cache.remove_slot(slot);
+    }
+
+    auto expected = std::vector<Displayable*>(count + 1);
+    for(auto i = 0uz; i < count; i += 1) {
+        if(!pages[i]) {
+            continue;
+        }
+        const auto loaded = pages[i]->state == Displayable::State::Loaded;
+        if(i < slot) {
+            expected[i] = pages[i].get();
+        } else if(!insert && i == slot) {
+            used -= loaded ? pages[i]->get_size() : 0;
+        } else if(loaded) {
+            expected[insert ? i + 1 : i - 1] = pages[i].get();
+        }
+    }
+    const auto op = insert ? "insert" : "remove";
+    for(auto i = 0uz; i < expected.size(); i += 1) {
+        if(cache.peek(i) != expected[i]) {
+            std::println("{} at {}: wrong page at {}", op, slot, i);
+            return false;
+        }
+    }
+    if(cache.get_used() != used) {
+        std::println("{} at {}: used {}MiB, expected {}MiB", op, slot, cache.get_used() / mib, used / mib);
+        return false;
+    }
+    // known sizes move too, they are what the budget walk plans with once a page is evicted
+    for(auto i = 0uz; i < expected.size(); i += 1) {
+        if(expected[i] == nullptr || expected[i]->state != Displayable::State::Loaded) {
+            continue;
+        }
+        cache.erase(i);
+        if(cache.estimate(i) != expected[i]->get_size()) {
+            std::println("{} at {}: wrong size estimate at {}", op, slot, i);
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+auto main() -> int {
+    auto ok = true;
+    for(const auto budget : {0uz, 31 * mib, 64 * mib, 100 * mib, 512 * mib, 4096 * mib}) {
+        for(const auto center : {0uz, 1uz, 10uz, 49uz}) {
+            // pages of the default estimate
+            ok &= test(PageCache(), center, 50, 1, budget);
+            ok &= test_claim(PageCache(), center, 1, 50, 1, budget);
+            ok &= test_claim(PageCache(), center, 2, 50, 1, budget);
+            // the pages on screen are claimed even when the budget covers none
+            ok &= test_claim(PageCache(), center, 2, 50, 0, budget);
+
+            // pages of mixed sizes already loaded around center
+            auto cache = PageCache();
+            for(auto i = center >= 3 ? center - 3 : 0; i < std::min(center + 4, 50uz); i += 2) {
+                cache.set(i, loaded_page((i % 3 + 1) * 20 * mib));
+            }
+            ok &= test(cache, center, 50, 1, budget);
+            ok &= test_claim(cache, center, 2, 50, 1, budget);
+        }
+    }
+    // before, at and after loaded pages(2, 5) and loading pages(3, 7)
+    for(const auto slot : {0uz, 2uz, 3uz, 4uz, 5uz, 6uz, 7uz, 9uz}) {
+        ok &= test_slot(true, slot);
+        ok &= test_slot(false, slot);
+    }
+    return ok ? 0 : 1;
+}
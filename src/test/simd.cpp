@@ -0,0 +1,62 @@
+#include <cstring>
+#include <print>
+#include <random>
+
+#include "../resample.hpp"
+
+// every kernel set must give exactly the result of the scalar one
+namespace {
+auto random_pixels(std::mt19937& rng, const size_t bytes) -> std::vector<std::byte> {
+    auto ret = std::vector<std::byte>(bytes);
+    for(auto& b : ret) {
+        b = std::byte(rng());
+    }
+    return ret;
+}
+
+auto test(const simd::Kernels& kernels, std::mt19937& rng) -> bool {
+    auto ok = true;
+    for(auto round = 0; round < 200; round += 1) {
+        // odd sizes cover the vector tails, reductions below and above 2x cover both filters
+        const auto src_width  = 1 + rng() % 300uz;
+        const auto src_height = 1 + rng() % 60uz;
+        const auto dst_width  = 1 + rng() % src_width;
+        const auto dst_height = 1 + rng() % src_height;
+        const auto src        = random_pixels(rng, src_width * src_height * 4);
+
+        if(area_average(src.data(), src_width, src_height, dst_width, dst_height, kernels) != area_average(src.data(), src_width, src_height, dst_width, dst_height, simd::scalar)) {
+            std::println("{}: area_average {}x{} -> {}x{} differs", kernels.name, src_width, src_height, dst_width, dst_height);
+            ok = false;
+        }
+        if(lanczos(src.data(), src_width, src_height, dst_width, dst_height, kernels) != lanczos(src.data(), src_width, src_height, dst_width, dst_height, simd::scalar)) {
+            std::println("{}: lanczos {}x{} -> {}x{} differs", kernels.name, src_width, src_height, dst_width, dst_height);
+            ok = false;
+        }
+
+        // in place from the tail of the buffer, as the jpeg decoder does
+        auto expanded = std::array<std::vector<std::byte>, 2>();
+        for(auto& buffer : expanded) {
+            buffer.resize(src_width * 4);
+            std::memcpy(buffer.data() + src_width, src.data(), src_width * 3);
+        }
+        expand_rgb(expanded[0].data() + src_width, expanded[0].data(), src_width, kernels);
+        expand_rgb(expanded[1].data() + src_width, expanded[1].data(), src_width, simd::scalar);
+        if(expanded[0] != expanded[1]) {
+            std::println("{}: expand_rgb of {} pixels differs", kernels.name, src_width);
+            ok = false;
+        }
+    }
+    return ok;
+}
+} // namespace
+
+auto main() -> int {
+    auto rng = std::mt19937(0);
+    auto ok  = true;
+    for(const auto kernels : simd::get_available()) {
+        if(kernels != &simd::scalar) {
+            ok &= test(*kernels, rng);
+        }
+    }
+    return ok ? 0 : 1;
+}
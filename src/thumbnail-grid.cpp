@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <thread>
+
+#include <coop/thread.hpp>
+
+#include "codec/jpeg.hpp"
+#include "gawl/misc.hpp"
+#include "macros/unwrap.hpp"
+#include "pipeline.hpp"
+#include "renumber.hpp"
+#include "resample.hpp"
+#include "thumbnail-grid.hpp"
+
+namespace {
+constexpr auto padding = 8uz; // between thumbnails
+
+struct Image {
+    size_t                 width;
+    size_t                 height;
+    std::vector<std::byte> pixels;
+};
+
+auto worker_count() -> size_t {
+    // leave the rest to the page decoders
+    return std::max(1u, std::thread::hardware_concurrency() / 2);
+}
+
+auto make_thumbnail(const Archive* const archive, const std::string& file, const std::filesystem::path& path) -> std::optional<Image> {
+    ensure(!file.ends_with(".txt"));
+    unwrap(data, read_page(archive, file, path));
+    const auto box = std::array{ThumbnailGrid::cell_size - padding, ThumbnailGrid::cell_size - padding};
+    if(auto scaled = decode_jpeg_scaled(data.bytes, box)) {
+        const auto fit = fit_size(scaled->full_width, scaled->full_height, box);
+        if(fit[0] != scaled->width || fit[1] != scaled->height) {
+            scaled->data = downscale(scaled->data.data(), scaled->width, scaled->height, fit[0], fit[1]);
+        }
+        return Image{fit[0], fit[1], std::move(scaled->data)};
+    }
+    unwrap(buf, gawl::PixelBuffer::from_blob(data.bytes.data(), data.bytes.size()));
+    const auto fit = fit_size(buf.get_width(), buf.get_height(), box);
+    if(fit[0] != buf.get_width() || fit[1] != buf.get_height()) {
+        return Image{fit[0], fit[1], downscale(buf.get_buffer(), buf.get_width(), buf.get_height(), fit[0], fit[1])};
+    }
+    const auto pixels = buf.get_buffer();
+    return Image{fit[0], fit[1], std::vector<std::byte>(pixels, pixels + fit[0] * fit[1] * 4)};
+}
+} // namespace
+
+auto ThumbnailGrid::get_rows() const -> size_t {
+    return (list.files.size() + columns - 1) / columns;
+}
+
+auto ThumbnailGrid::get_max_scroll() const -> double {
+    return std::max(0.0, 1. * get_rows() * cell_size - height);
+}
+
+// [first, last) rows intersecting the screen
+auto ThumbnailGrid::get_visible_rows() const -> std::array<size_t, 2> {
+    const auto first = size_t(scroll) / cell_size;
+    const auto last  = std::min(get_rows(), (size_t(scroll) + height + cell_size - 1) / cell_size);
+    return {first, std::max(first, last)};
+}
+
+// visible cells top to bottom, then half a screen below, then half a screen above
+// thumbnails outside of this window are only kept until the lru needs room
+auto ThumbnailGrid::next_wanted() const -> std::optional<size_t> {
+    if(!active) {
+        return std::nullopt;
+    }
+    const auto [first, last] = get_visible_rows();
+    const auto margin        = std::max(1uz, (last - first) / 2);
+    const auto ranges        = std::array{
+        std::array{first, last},
+        std::array{last, std::min(get_rows(), last + margin)},
+        std::array{first - std::min(first, margin), first},
+    };
+    for(const auto [begin, end] : ranges) {
+        for(auto i = begin * columns; i < std::min(end * columns, list.files.size()); i += 1) {
+            if(!thumbnails.contains(i) && !loading.contains(i) && !failed.contains(i)) {
+                return i;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+auto ThumbnailGrid::evict() -> void {
+    while(thumbnails.size() > max_thumbnails) {
+        const auto victim = std::ranges::min_element(thumbnails, {}, [](const auto& pair) { return pair.second.last_used; });
+        thumbnails.erase(victim);
+    }
+}
+
+auto ThumbnailGrid::compose(const size_t row) const -> gawl::PixelBuffer {
+    const auto width  = columns * cell_size;
+    auto       pixels = std::vector<std::byte>(width * cell_size * 4);
+    for(auto column = 0uz; column < columns; column += 1) {
+        const auto it = thumbnails.find(row * columns + column);
+        if(it == thumbnails.end()) {
+            continue;
+        }
+        // centered in the cell
+        const auto& thumb = it->second;
+        const auto  x     = column * cell_size + (cell_size - thumb.width) / 2;
+        const auto  y     = (cell_size - thumb.height) / 2;
+        for(auto ty = 0uz; ty < thumb.height; ty += 1) {
+            const auto src = thumb.pixels.data() + ty * thumb.width * 4;
+            std::copy(src, src + thumb.width * 4, pixels.data() + ((y + ty) * width + x) * 4);
+        }
+    }
+    return gawl::PixelBuffer::from_raw(width, cell_size, std::move(pixels));
+}
+
+auto ThumbnailGrid::follow_selection() -> void {
+    const auto top = 1. * (selected / columns) * cell_size;
+    // the top edge wins if the screen is shorter than a cell
+    scroll = std::min(std::max(scroll, top + cell_size - height), top);
+}
+
+auto ThumbnailGrid::worker_main() -> coop::Async<void> {
+loop:
+    const auto index = next_wanted();
+    if(!index) {
+        co_await wanted_event;
+        goto loop;
+    }
+    // jobs are picked when a worker is free, so cells scrolled away before that are never decoded
+    loading.insert(*index);
+    const auto gen   = generation;
+    auto       image = co_await coop::run_blocking([archive = list.archive, file = std::string(list.files[*index]), path = list.prefix / list.files[*index]]() {
+        return make_thumbnail(archive.get(), file, path);
+    });
+    if(gen != generation) {
+        // list replaced while decoding
+        goto loop;
+    }
+    loading.erase(*index);
+    if(!image) {
+        failed.insert(*index);
+        goto loop;
+    }
+    tick += 1;
+    thumbnails.emplace(*index, Thumbnail{image->width, image->height, std::move(image->pixels), tick});
+    evict();
+    if(const auto it = bands.find(*index / columns); it != bands.end()) {
+        it->second.dirty = true;
+        on_ready();
+    }
+    goto loop;
+}
+
+auto ThumbnailGrid::open(const FileList& list, const size_t index) -> void {
+    if(this->list.prefix != list.prefix || this->list.files != list.files) {
+        this->list  = list;
+        generation += 1;
+        thumbnails.clear();
+        loading.clear();
+        failed.clear();
+        bands.clear();
+    }
+    active   = true;
+    selected = std::min(index, list.files.empty() ? 0 : list.files.size() - 1);
+    if(height != 0) {
+        follow_selection();
+    }
+    wanted_event.notify();
+}
+
+auto ThumbnailGrid::shift_slots(const std::function<size_t(size_t)>& shift) -> void {
+    renumber(thumbnails, shift);
+    renumber(failed, shift);
+    // results of running decodes refer to the old indices
+    generation += 1;
+    loading.clear();
+    bands.clear();
+    selected = std::min(shift(selected), list.files.empty() ? 0 : list.files.size() - 1);
+    wanted_event.notify();
+}
+
+auto ThumbnailGrid::insert_slot(const FileList& list, const size_t index) -> void {
+    if(this->list.prefix != list.prefix || this->list.files.size() + 1 != list.files.size()) {
+        return;
+    }
+    this->list.files.insert(index, list.files[index]);
+    shift_slots([index](const size_t i) { return i >= index ? i + 1 : i; });
+}
+
+auto ThumbnailGrid::remove_slot(const FileList& list, const size_t index) -> void {
+    if(this->list.prefix != list.prefix || this->list.files.size() != list.files.size() + 1) {
+        return;
+    }
+    this->list.files.erase(index);
+    thumbnails.erase(index);
+    failed.erase(index);
+    shift_slots([index](const size_t i) { return i > index ? i - 1 : i; });
+}
+
+auto ThumbnailGrid::reload_slot(const FileList& list, const size_t index) -> void {
+    if(this->list.prefix != list.prefix || this->list.files.size() != list.files.size()) {
+        return;
+    }
+    thumbnails.erase(index);
+    failed.erase(index);
+    if(loading.contains(index)) {
+        // the running decode may have read the old file
+        generation += 1;
+        loading.clear();
+    }
+    if(const auto it = bands.find(index / columns); it != bands.end()) {
+        it->second.dirty = true;
+    }
+    wanted_event.notify();
+}
+
+auto ThumbnailGrid::close() -> void {
+    active = false;
+    // textures are released, decoded thumbnails stay for the next open
+    bands.clear();
+}
+
+auto ThumbnailGrid::get_selected() const -> size_t {
+    return selected;
+}
+
+auto ThumbnailGrid::select(const size_t index) -> void {
+    if(index < list.files.size()) {
+        selected = index;
+    }
+}
+
+auto ThumbnailGrid::move_selection(const int dx, const int dy) -> void {
+    if(list.files.empty()) {
+        return;
+    }
+    const auto delta = int64_t(dx) + int64_t(dy) * int64_t(columns);
+    selected         = size_t(std::clamp(int64_t(selected) + delta, int64_t(0), int64_t(list.files.size() - 1)));
+    follow_selection();
+}
+
+auto ThumbnailGrid::scroll_by(const double dy) -> void {
+    // clamped right away, workers read the visible range before the next draw
+    scroll = std::clamp(scroll + dy, 0.0, get_max_scroll());
+}
+
+auto ThumbnailGrid::find_cell(const gawl::Point point) const -> std::optional<size_t> {
+    ensure(point.x >= 0 && point.y >= 0 && point.x < 1. * columns * cell_size);
+    const auto index = size_t((point.y + scroll) / cell_size) * columns + size_t(point.x / cell_size);
+    ensure(index < list.files.size());
+    return index;
+}
+
+auto ThumbnailGrid::draw(gawl::Screen& screen, const std::array<int, 2> screen_size) -> void {
+    const auto new_columns = std::max(1uz, size_t(screen_size[0]) / cell_size);
+    if(new_columns != columns || size_t(screen_size[1]) != height) {
+        if(new_columns != columns) {
+            bands.clear();
+        }
+        columns = new_columns;
+        height  = size_t(screen_size[1]);
+        follow_selection();
+    }
+    scroll = std::clamp(scroll, 0.0, get_max_scroll());
+
+    const auto rows = get_visible_rows();
+    if(rows != drawn_rows) {
+        drawn_rows = rows;
+        std::erase_if(bands, [&rows](const auto& pair) { return pair.first < rows[0] || pair.first >= rows[1]; });
+        wanted_event.notify();
+    }
+    for(auto row = rows[0]; row < rows[1]; row += 1) {
+        auto& band = bands[row];
+        if(band.dirty) {
+            band.graphic = gawl::Graphic(compose(row));
+            band.dirty   = false;
+        }
+        const auto top = 1. * row * cell_size - scroll;
+        band.graphic.draw_rect(screen, {{0, top}, {1. * columns * cell_size, top + cell_size}});
+        tick += 1;
+        for(auto i = row * columns; i < std::min((row + 1) * columns, list.files.size()); i += 1) {
+            if(const auto it = thumbnails.find(i); it != thumbnails.end()) {
+                it->second.last_used = tick;
+            }
+        }
+    }
+
+    const auto x = 1. * (selected % columns) * cell_size;
+    const auto y = 1. * (selected / columns) * cell_size - scroll;
+    gawl::draw_rect(screen, {{x, y}, {x + cell_size, y + cell_size}}, {1, 1, 1, 0.3});
+}
+
+auto ThumbnailGrid::start(coop::Runner& runner) -> void {
+    workers.resize(worker_count());
+    for(auto& handle : workers) {
+        runner.push_task(worker_main(), &handle);
+    }
+}
+
+auto ThumbnailGrid::stop() -> void {
+    for(auto& handle : workers) {
+        handle.cancel();
+    }
+}
+
+ThumbnailGrid::ThumbnailGrid(std::function<void()> on_ready)
+    : on_ready(std::move(on_ready)) {}
@@ -0,0 +1,82 @@
+#pragma once
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <coop/generator.hpp>
+#include <coop/multi-event.hpp>
+#include <coop/task-handle.hpp>
+
+#include "file-list.hpp"
+#include "gawl/graphic.hpp"
+
+// overview of every page of a work
+// thumbnails are decoded by parallel workers, cells on screen first, and every grid row is drawn from a single texture
+// decoded thumbnails are kept in a bounded lru and rows are uploaded only while visible, so memory does not grow with the work
+class ThumbnailGrid {
+  public:
+    constexpr static auto cell_size      = 160uz; // px
+    constexpr static auto max_thumbnails = 768uz; // about 70MiB
+
+  private:
+    struct Thumbnail {
+        size_t                 width;
+        size_t                 height;
+        std::vector<std::byte> pixels;
+        size_t                 last_used;
+    };
+    struct Band {
+        gawl::Graphic graphic;
+        bool          dirty = true; // a thumbnail of the row arrived after the upload
+    };
+
+    FileList                              list;
+    std::unordered_map<size_t, Thumbnail> thumbnails; // by page index
+    std::unordered_set<size_t>            loading;
+    std::unordered_set<size_t>            failed;
+    std::unordered_map<size_t, Band>      bands; // by row, only rows on screen
+    std::function<void()>                 on_ready;
+    coop::MultiEvent                      wanted_event; // the visible range changed
+    std::vector<coop::TaskHandle>         workers;
+    size_t                                generation = 0; // bumped when list is replaced
+    size_t                                tick       = 0;
+    size_t                                columns    = 1;
+    size_t                                selected   = 0;
+    size_t                                height     = 0; // of the screen, last drawn
+    double                                scroll     = 0; // px from the top of the grid
+    std::array<size_t, 2>                 drawn_rows = {0, 0};
+    bool                                  active     = false;
+
+    auto get_rows() const -> size_t;
+    auto get_max_scroll() const -> double;
+    auto get_visible_rows() const -> std::array<size_t, 2>;
+    auto next_wanted() const -> std::optional<size_t>;
+    auto evict() -> void;
+    auto compose(size_t row) const -> gawl::PixelBuffer;
+    auto follow_selection() -> void;
+    auto shift_slots(const std::function<size_t(size_t)>& shift) -> void;
+    auto worker_main() -> coop::Async<void>;
+
+  public:
+    // keeps the thumbnails if list is the same work as last time
+    auto open(const FileList& list, size_t index) -> void;
+    auto close() -> void;
+    // a file was inserted into or removed from the work, list is the updated one
+    // thumbnails of the other pages move to their new index instead of being decoded again
+    auto insert_slot(const FileList& list, size_t index) -> void;
+    auto remove_slot(const FileList& list, size_t index) -> void;
+    // the file was rewritten, its thumbnail is decoded again
+    auto reload_slot(const FileList& list, size_t index) -> void;
+    auto get_selected() const -> size_t;
+    auto select(size_t index) -> void;
+    auto move_selection(int dx, int dy) -> void;
+    auto scroll_by(double dy) -> void;
+    // page under the point, if any
+    auto find_cell(gawl::Point point) const -> std::optional<size_t>;
+    auto draw(gawl::Screen& screen, std::array<int, 2> screen_size) -> void;
+    auto start(coop::Runner& runner) -> void;
+    auto stop() -> void;
+
+    // on_ready: a thumbnail is ready to be drawn
+    ThumbnailGrid(std::function<void()> on_ready);
+};
@@ -0,0 +1,87 @@
+#include <array>
+#include <format>
+#include <fstream>
+
+#include "macros/assert.hpp"
+#include "trace.hpp"
+
+namespace {
+auto to_ms(const TraceClock::duration duration) -> double {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+auto to_us(const TraceClock::duration duration) -> long long {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+auto escape(const std::string_view str) -> std::string {
+    auto ret = std::string();
+    for(const auto c : str) {
+        if(c == '"' || c == '\\') {
+            ret += '\\';
+            ret += c;
+        } else if(uint8_t(c) < 0x20) {
+            ret += std::format("\\u{:04x}", int(c));
+        } else {
+            ret += c;
+        }
+    }
+    return ret;
+}
+} // namespace
+
+auto Trace::add(std::string name, const size_t lane, const TraceClock::time_point begin, const TraceClock::time_point end, std::string page) -> void {
+    if(events.size() >= max_events || begin == TraceClock::time_point()) {
+        return;
+    }
+    events.push_back(Event{std::move(name), std::move(page), lane, begin, end});
+}
+
+auto Trace::add_page(const PageTiming& timing, const std::string& page) -> void {
+    const auto decode_wait_begin = timing.read_begin != TraceClock::time_point() ? timing.read_end : timing.claimed;
+    add("read", Lane::Read, timing.read_begin, timing.read_end, page);
+    if(timing.decode_begin != TraceClock::time_point()) {
+        add("wait decode", Lane::Queue, decode_wait_begin, timing.decode_begin, page);
+        add("decode", Lane::Decode + timing.decoder, timing.decode_begin, timing.decode_end, page);
+        add("wait upload", Lane::Queue, timing.decode_end, timing.upload_begin, page);
+    }
+    add("upload", Lane::Upload, timing.upload_begin, timing.upload_end, page);
+}
+
+auto Trace::save(const std::filesystem::path& path) const -> bool {
+    auto out = std::ofstream(path);
+    ensure(out, "failed to open {}", path.string());
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)" << '\n';
+    // name the tracks
+    const auto names = std::array<std::pair<size_t, std::string_view>, 4>{{{Lane::Render, "render"}, {Lane::Read, "read"}, {Lane::Upload, "upload"}, {Lane::Queue, "queue"}}};
+    for(const auto& [lane, name] : names) {
+        out << std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}},)", lane, name) << '\n';
+    }
+    for(const auto& e : events) {
+        // queue waits of parallel pages overlap, so they are async events keyed by page
+        if(e.lane == Lane::Queue) {
+            out << std::format(R"({{"name":"{}","cat":"queue","ph":"b","id":"{}","pid":1,"tid":{},"ts":{}}},)", e.name, escape(e.page), e.lane, to_us(e.begin - origin)) << '\n';
+            out << std::format(R"({{"name":"{}","cat":"queue","ph":"e","id":"{}","pid":1,"tid":{},"ts":{}}},)", e.name, escape(e.page), e.lane, to_us(e.end - origin)) << '\n';
+            continue;
+        }
+        out << std::format(R"({{"name":"{}","cat":"page","ph":"X","pid":1,"tid":{},"ts":{},"dur":{},"args":{{"page":"{}"}}}},)",
+                           e.name, e.lane, to_us(e.begin - origin), to_us(e.end - e.begin), escape(e.page))
+            << '\n';
+    }
+    // trailing comma is not allowed, close with an empty metadata event
+    out << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"imgview"}}]})" << '\n';
+    ensure(out, "failed to write {}", path.string());
+    return true;
+}
+
+auto format_timing(const PageTiming& timing) -> std::string {
+    if(timing.upload_end == TraceClock::time_point()) {
+        return {};
+    }
+    const auto zero   = TraceClock::duration(0);
+    const auto read   = timing.read_begin != TraceClock::time_point() ? timing.read_end - timing.read_begin : zero;
+    const auto decode = timing.decode_begin != TraceClock::time_point() ? timing.decode_end - timing.decode_begin : zero;
+    const auto upload = timing.upload_end - timing.upload_begin;
+    const auto wait   = (timing.upload_end - timing.claimed) - read - decode - upload;
+    return std::format("read {:.1f} decode {:.1f} upload {:.1f} wait {:.1f} (ms)", to_ms(read), to_ms(decode), to_ms(upload), to_ms(wait));
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using TraceClock = std::chrono::steady_clock;
+
+// when a page went through each pipeline stage
+// a stage not run (e.g. decode for a disk cache hit) keeps an empty begin
+struct PageTiming {
+    TraceClock::time_point claimed;
+    TraceClock::time_point read_begin;
+    TraceClock::time_point read_end;
+    TraceClock::time_point decode_begin;
+    TraceClock::time_point decode_end;
+    TraceClock::time_point upload_begin;
+    TraceClock::time_point upload_end;
+    size_t                 decoder = 0; // which decoder ran the page
+};
+
+// spans exported as chrome trace event json, loadable in perfetto or chrome://tracing
+// only used from the runner thread
+class Trace {
+  public:
+    // tracks in the trace, decoders follow the last one
+    enum Lane : size_t {
+        Render = 1,
+        Read,
+        Upload,
+        Queue, // time spent waiting between stages
+        Decode,
+    };
+
+  private:
+    struct Event {
+        std::string            name;
+        std::string            page;
+        size_t                 lane;
+        TraceClock::time_point begin;
+        TraceClock::time_point end;
+    };
+
+    std::vector<Event>     events;
+    TraceClock::time_point origin = TraceClock::now();
+
+  public:
+    constexpr static auto max_events = 1'000'000uz;
+
+    auto add(std::string name, size_t lane, TraceClock::time_point begin, TraceClock::time_point end, std::string page = {}) -> void;
+    // adds every stage of a loaded page
+    auto add_page(const PageTiming& timing, const std::string& page) -> void;
+    auto save(const std::filesystem::path& path) const -> bool;
+};
+
+// "read 1.2 decode 30.5 upload 4.1 wait 10.0 (ms)"
+auto format_timing(const PageTiming& timing) -> std::string;